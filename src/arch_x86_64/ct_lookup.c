@@ -0,0 +1,85 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+#include "word.h"
+#include "constant_time.h"
+#include "f_dispatch.h"
+
+/* Only these functions are built for AVX2 and AVX-512; goldilocks_wide_lookup
+ * checks goldilocks_cpu_features() before calling them.
+ */
+
+/* Scan the whole table, ORing each entry into accumulators that are kept in
+ * registers, under an all-ones mask for entry idx and all-zeros otherwise.
+ * E is the entry size, a compile-time constant in each instance.
+ */
+#define WIDE_LOOKUP(T, E) do {                                          \
+    T acc[(E)/sizeof(T)], vi, one, zero, mask, x;                       \
+    word_t j, k;                                                        \
+    for (k=0; k<sizeof(T)/sizeof(uint64_t); k++) {                      \
+        vi[k] = idx;                                                    \
+        one[k] = 1;                                                     \
+        zero[k] = 0;                                                    \
+    }                                                                   \
+    for (k=0; k<(E)/sizeof(T); k++) acc[k] = zero;                      \
+    for (j=0; j<n_table; j++, vi-=one) {                                \
+        mask = (T)(vi == zero);                                         \
+        for (k=0; k<(E)/sizeof(T); k++) {                               \
+            memcpy(&x, &table[j*(E) + k*sizeof(T)], sizeof(T));        \
+            acc[k] |= x & mask;                                         \
+        }                                                               \
+    }                                                                   \
+    memcpy(out, acc, (E));                                              \
+    goldilocks_bzero(acc, sizeof(acc));                                 \
+} while (0)
+
+#ifndef __AVX2__
+/* Otherwise big_register_t is already this wide */
+static __attribute__((target("avx2"))) void lookup_avx2 (
+    unsigned char *__restrict__ out,
+    const unsigned char *table,
+    word_t elem_bytes,
+    word_t n_table,
+    word_t idx
+) {
+    if (elem_bytes == 192) WIDE_LOOKUP(uint64x4_t, 192);
+    else WIDE_LOOKUP(uint64x4_t, 256);
+}
+#endif
+
+static __attribute__((target("avx512f"))) void lookup_avx512 (
+    unsigned char *__restrict__ out,
+    const unsigned char *table,
+    word_t elem_bytes,
+    word_t n_table,
+    word_t idx
+) {
+    if (elem_bytes == 192) WIDE_LOOKUP(uint64x8_t, 192);
+    else WIDE_LOOKUP(uint64x8_t, 256);
+}
+
+int goldilocks_wide_lookup (
+    void *__restrict__ out,
+    const void *table,
+    word_t elem_bytes,
+    word_t n_table,
+    word_t idx
+) {
+    unsigned int cpu = goldilocks_cpu_features();
+
+    /* The sizes of niels and pniels points */
+    if (elem_bytes != 192 && elem_bytes != 256) return 0;
+
+    if (cpu & GOLDILOCKS_CPU_AVX512) {
+        lookup_avx512((unsigned char *)out, (const unsigned char *)table, elem_bytes, n_table, idx);
+        return 1;
+    }
+#ifndef __AVX2__
+    if (cpu & GOLDILOCKS_CPU_AVX2) {
+        lookup_avx2((unsigned char *)out, (const unsigned char *)table, elem_bytes, n_table, idx);
+        return 1;
+    }
+#endif
+    return 0;
+}
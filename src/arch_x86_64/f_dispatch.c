@@ -0,0 +1,61 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+#include "f_dispatch.h"
+
+#if GOLDILOCKS_RUNTIME_DISPATCH
+
+typedef void (*gf_mul_fn) (gf_s *__restrict__ out, const gf a, const gf b);
+typedef void (*gf_sqr_fn) (gf_s *__restrict__ out, const gf a);
+typedef void (*gf_mulw_unsigned_fn) (gf_s *__restrict__ out, const gf a, uint32_t b);
+
+static void mul_resolve (gf_s *__restrict__ out, const gf a, const gf b);
+static void sqr_resolve (gf_s *__restrict__ out, const gf a);
+static void mulw_unsigned_resolve (gf_s *__restrict__ out, const gf a, uint32_t b);
+
+/* Each entry starts out pointing at a stub which fills in the table */
+static gf_mul_fn mul_impl = mul_resolve;
+static gf_sqr_fn sqr_impl = sqr_resolve;
+static gf_mulw_unsigned_fn mulw_unsigned_impl = mulw_unsigned_resolve;
+
+static void resolve (void) {
+    if (goldilocks_cpu_features() & GOLDILOCKS_CPU_BMI2) {
+        __atomic_store_n(&mul_impl, gf_448_mul_bmi2, __ATOMIC_RELAXED);
+        __atomic_store_n(&sqr_impl, gf_448_sqr_bmi2, __ATOMIC_RELAXED);
+        __atomic_store_n(&mulw_unsigned_impl, gf_448_mulw_unsigned_bmi2, __ATOMIC_RELAXED);
+    } else {
+        __atomic_store_n(&mul_impl, gf_448_mul_generic, __ATOMIC_RELAXED);
+        __atomic_store_n(&sqr_impl, gf_448_sqr_generic, __ATOMIC_RELAXED);
+        __atomic_store_n(&mulw_unsigned_impl, gf_448_mulw_unsigned_generic, __ATOMIC_RELAXED);
+    }
+}
+
+static void mul_resolve (gf_s *__restrict__ out, const gf a, const gf b) {
+    resolve();
+    mul_impl(out,a,b);
+}
+
+static void sqr_resolve (gf_s *__restrict__ out, const gf a) {
+    resolve();
+    sqr_impl(out,a);
+}
+
+static void mulw_unsigned_resolve (gf_s *__restrict__ out, const gf a, uint32_t b) {
+    resolve();
+    mulw_unsigned_impl(out,a,b);
+}
+
+void gf_mul (gf_s *__restrict__ out, const gf a, const gf b) {
+    __atomic_load_n(&mul_impl, __ATOMIC_RELAXED)(out,a,b);
+}
+
+void gf_sqr (gf_s *__restrict__ out, const gf a) {
+    __atomic_load_n(&sqr_impl, __ATOMIC_RELAXED)(out,a);
+}
+
+void gf_mulw_unsigned (gf_s *__restrict__ out, const gf a, uint32_t b) {
+    __atomic_load_n(&mulw_unsigned_impl, __ATOMIC_RELAXED)(out,a,b);
+}
+
+#endif /* GOLDILOCKS_RUNTIME_DISPATCH */
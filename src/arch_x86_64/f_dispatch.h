@@ -0,0 +1,22 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+#ifndef __ARCH_X86_64_F_DISPATCH_H__
+#define __ARCH_X86_64_F_DISPATCH_H__ 1
+
+#include "f_field.h"
+#include "cpu_features.h"
+
+#if GOLDILOCKS_RUNTIME_DISPATCH
+/* f_impl.c is built once per multiplier, and f_dispatch.c picks one */
+void gf_448_mul_generic (gf_s *__restrict__ out, const gf a, const gf b);
+void gf_448_sqr_generic (gf_s *__restrict__ out, const gf a);
+void gf_448_mulw_unsigned_generic (gf_s *__restrict__ out, const gf a, uint32_t b);
+
+void gf_448_mul_bmi2 (gf_s *__restrict__ out, const gf a, const gf b);
+void gf_448_sqr_bmi2 (gf_s *__restrict__ out, const gf a);
+void gf_448_mulw_unsigned_bmi2 (gf_s *__restrict__ out, const gf a, uint32_t b);
+#endif
+
+#endif /* __ARCH_X86_64_F_DISPATCH_H__ */
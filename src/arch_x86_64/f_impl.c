@@ -4,8 +4,17 @@
  */
 
 #include "f_field.h"
+#include "f_dispatch.h"
 
-void gf_mul (gf_s *__restrict__ cs, const gf as, const gf bs) {
+#ifndef GF_IMPL_NAME
+#if GOLDILOCKS_RUNTIME_DISPATCH
+#define GF_IMPL_NAME(x) x##_generic
+#else
+#define GF_IMPL_NAME(x) x
+#endif
+#endif
+
+void GF_IMPL_NAME(gf_448_mul) (gf_s *__restrict__ cs, const gf as, const gf bs) {
     const uint64_t *a = as->limb, *b = bs->limb;
     uint64_t *c = cs->limb;
 
@@ -140,7 +149,7 @@ void gf_mul (gf_s *__restrict__ cs, const gf as, const gf bs) {
     c[0] += ((uint64_t)(accum1));
 }
 
-void gf_mulw_unsigned (gf_s *__restrict__ cs, const gf as, uint32_t b) {
+void GF_IMPL_NAME(gf_448_mulw_unsigned) (gf_s *__restrict__ cs, const gf as, uint32_t b) {
     const uint64_t *a = as->limb;
     uint64_t *c = cs->limb;
 
@@ -180,7 +189,7 @@ void gf_mulw_unsigned (gf_s *__restrict__ cs, const gf as, uint32_t b) {
     c[1] += accum4 >> 56;
 }
 
-void gf_sqr (gf_s *__restrict__ cs, const gf as) {
+void GF_IMPL_NAME(gf_448_sqr) (gf_s *__restrict__ cs, const gf as) {
     const uint64_t *a = as->limb;
     uint64_t *c = cs->limb;
 
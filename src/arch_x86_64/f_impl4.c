@@ -0,0 +1,265 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+#include "field4.h"
+#include "f_dispatch.h"
+
+#if !GF4_VECTORIZED
+#error "The four-way field arithmetic is only built on x86_64"
+#endif
+
+/* Built for AVX2 even when the rest of the library isn't; see gf4_supported(). */
+#define GF4_TARGET __attribute__((target("avx2")))
+
+#if (defined(__OPTIMIZE__) && !defined(__OPTIMIZE_SIZE__) && !I_HATE_UNROLLED_LOOPS) \
+     || defined(GOLDILOCKS_FORCE_UNROLL)
+#define REPEAT8(_x) _x _x _x _x _x _x _x _x
+#define FOR_LIMB(_i,_start,_end,_x) do { _i=_start; REPEAT8( if (_i<_end) { _x; } _i++;) } while (0)
+#else
+#define FOR_LIMB(_i,_start,_end,_x) do { for (_i=_start; _i<_end; _i++) _x; } while (0)
+#endif
+
+#define MASK28 ((1ull<<28)-1)
+
+/* Multiply the low 32 bits of each lane */
+static GF4_TARGET GOLDILOCKS_INLINE uint64x4_t widemul4(uint64x4_t a, uint64x4_t b) {
+    return (uint64x4_t)_mm256_mul_epu32((__m256i)a, (__m256i)b);
+}
+
+static GF4_TARGET GOLDILOCKS_INLINE uint64x4_t splat4(uint64_t x) {
+    uint64x4_t ret = {x,x,x,x};
+    return ret;
+}
+
+static GF4_TARGET GOLDILOCKS_INLINE void gf4_weak_reduce (gf4 a) {
+    const uint64x4_t mask = splat4(MASK28);
+    uint64x4_t tmp = a->limb[15] >> 28;
+    unsigned int i;
+    a->limb[8] += tmp;
+    for (i=15; i>0; i--) {
+        a->limb[i] = (a->limb[i] & mask) + (a->limb[i-1] >> 28);
+    }
+    a->limb[0] = (a->limb[0] & mask) + tmp;
+}
+
+int gf4_supported (void) {
+    return !!(goldilocks_cpu_features() & GOLDILOCKS_CPU_AVX2);
+}
+
+GF4_TARGET void gf4_add (gf4 out, const gf4 a, const gf4 b) {
+    unsigned int i;
+    for (i=0; i<16; i++) {
+        out->limb[i] = a->limb[i] + b->limb[i];
+    }
+    gf4_weak_reduce(out);
+}
+
+GF4_TARGET void gf4_sub (gf4 out, const gf4 a, const gf4 b) {
+    /* Bias by 2p */
+    const uint64x4_t co1 = splat4(MASK28*2), co2 = splat4(MASK28*2-2);
+    unsigned int i;
+    for (i=0; i<16; i++) {
+        out->limb[i] = a->limb[i] - b->limb[i] + ((i==8) ? co2 : co1);
+    }
+    gf4_weak_reduce(out);
+}
+
+GF4_TARGET void gf4_mul (gf4_s *__restrict__ cs, const gf4 as, const gf4 bs) {
+    const uint64x4_t *a = as->limb, *b = bs->limb;
+    uint64x4_t *c = cs->limb;
+
+    uint64x4_t accum0 = splat4(0), accum1 = splat4(0), accum2;
+    const uint64x4_t mask = splat4(MASK28);
+
+    uint64x4_t aa[8], bb[8];
+
+    int i,j;
+    for (i=0; i<8; i++) {
+        aa[i] = a[i] + a[i+8];
+        bb[i] = b[i] + b[i+8];
+    }
+
+    FOR_LIMB(j,0,8,{
+        accum2 = splat4(0);
+
+        FOR_LIMB (i,0,j+1,{
+            accum2 += widemul4(a[j-i],b[i]);
+            accum1 += widemul4(aa[j-i],bb[i]);
+            accum0 += widemul4(a[8+j-i], b[8+i]);
+        });
+
+        accum1 -= accum2;
+        accum0 += accum2;
+        accum2 = splat4(0);
+
+        FOR_LIMB (i,j+1,8,{
+            accum0 -= widemul4(a[8+j-i], b[i]);
+            accum2 += widemul4(aa[8+j-i], bb[i]);
+            accum1 += widemul4(a[16+j-i], b[8+i]);
+        });
+
+        accum1 += accum2;
+        accum0 += accum2;
+
+        c[j] = accum0 & mask;
+        c[j+8] = accum1 & mask;
+
+        accum0 >>= 28;
+        accum1 >>= 28;
+    });
+
+    accum0 += accum1;
+    accum0 += c[8];
+    accum1 += c[0];
+    c[8] = accum0 & mask;
+    c[0] = accum1 & mask;
+
+    accum0 >>= 28;
+    accum1 >>= 28;
+    c[9] += accum0;
+    c[1] += accum1;
+}
+
+GF4_TARGET void gf4_sqr (gf4_s *__restrict__ cs, const gf4 as) {
+    /* Same as gf4_mul(cs,as,as), but the cross terms are computed once and doubled */
+    const uint64x4_t *a = as->limb;
+    uint64x4_t *c = cs->limb;
+
+    uint64x4_t accum0 = splat4(0), accum1 = splat4(0), accum2;
+    const uint64x4_t mask = splat4(MASK28);
+
+    uint64x4_t aa[8], a2[16], aa2[8];
+
+    int i,j,h;
+    for (i=0; i<8; i++) {
+        aa[i] = a[i] + a[i+8];
+        aa2[i] = aa[i] + aa[i];
+    }
+    for (i=0; i<16; i++) {
+        a2[i] = a[i] + a[i];
+    }
+
+    FOR_LIMB(j,0,8,{
+        accum2 = splat4(0);
+
+        FOR_LIMB (i,0,(j+1)/2,{
+            accum2 += widemul4(a2[j-i],a[i]);
+            accum1 += widemul4(aa2[j-i],aa[i]);
+            accum0 += widemul4(a2[8+j-i], a[8+i]);
+        });
+        if (!(j&1)) {
+            h = j/2;
+            accum2 += widemul4(a[h],a[h]);
+            accum1 += widemul4(aa[h],aa[h]);
+            accum0 += widemul4(a[8+h], a[8+h]);
+        }
+
+        accum1 -= accum2;
+        accum0 += accum2;
+        accum2 = splat4(0);
+
+        FOR_LIMB (i,j+1,(9+j)/2,{
+            accum0 -= widemul4(a2[8+j-i], a[i]);
+            accum2 += widemul4(aa2[8+j-i], aa[i]);
+            accum1 += widemul4(a2[16+j-i], a[8+i]);
+        });
+        if (!(j&1) && j < 7) {
+            h = (8+j)/2;
+            accum0 -= widemul4(a[h], a[h]);
+            accum2 += widemul4(aa[h], aa[h]);
+            accum1 += widemul4(a[8+h], a[8+h]);
+        }
+
+        accum1 += accum2;
+        accum0 += accum2;
+
+        c[j] = accum0 & mask;
+        c[j+8] = accum1 & mask;
+
+        accum0 >>= 28;
+        accum1 >>= 28;
+    });
+
+    accum0 += accum1;
+    accum0 += c[8];
+    accum1 += c[0];
+    c[8] = accum0 & mask;
+    c[0] = accum1 & mask;
+
+    accum0 >>= 28;
+    accum1 >>= 28;
+    c[9] += accum0;
+    c[1] += accum1;
+}
+
+GF4_TARGET void gf4_mulw_unsigned (gf4_s *__restrict__ cs, const gf4 as, uint32_t w) {
+    const uint64x4_t *a = as->limb;
+    uint64x4_t *c = cs->limb;
+
+    const uint64x4_t b = splat4(w), mask = splat4(MASK28);
+    uint64x4_t accum0 = splat4(0), accum8 = splat4(0);
+
+    int i;
+    assert(w<1<<28);
+
+    FOR_LIMB(i,0,8,{
+        accum0 += widemul4(b, a[i]);
+        accum8 += widemul4(b, a[i+8]);
+
+        c[i] = accum0 & mask; accum0 >>= 28;
+        c[i+8] = accum8 & mask; accum8 >>= 28;
+    });
+
+    accum0 += accum8 + c[8];
+    c[8] = accum0 & mask;
+    c[9] += accum0 >> 28;
+
+    accum8 += c[0];
+    c[0] = accum8 & mask;
+    c[1] += accum8 >> 28;
+}
+
+GF4_TARGET void gf4_cond_swap (gf4 x, gf4_s *__restrict__ y, const mask_t swap[4]) {
+    const uint64x4_t m = { swap[0], swap[1], swap[2], swap[3] };
+    unsigned int i;
+    for (i=0; i<16; i++) {
+        uint64x4_t s = (x->limb[i] ^ y->limb[i]) & m;
+        x->limb[i] ^= s;
+        y->limb[i] ^= s;
+    }
+}
+
+/* The conversions only move bits around, so they don't need AVX2 */
+
+void gf4_load (gf4 out, const gf a, const gf b, const gf c, const gf d) {
+    gf in[4];
+    unsigned int i, j;
+    gf_copy(in[0],a);
+    gf_copy(in[1],b);
+    gf_copy(in[2],c);
+    gf_copy(in[3],d);
+    for (j=0; j<4; j++) {
+        gf_weak_reduce(in[j]);
+        for (i=0; i<8; i++) {
+            out->limb[2*i][j] = in[j]->limb[i] & MASK28;
+            out->limb[2*i+1][j] = in[j]->limb[i] >> 28;
+        }
+    }
+    goldilocks_bzero(in,sizeof(in));
+}
+
+void gf4_store (gf a, gf b, gf c, gf d, const gf4 in) {
+    gf_s *out[4];
+    unsigned int i, j;
+    out[0] = a;
+    out[1] = b;
+    out[2] = c;
+    out[3] = d;
+    for (j=0; j<4; j++) {
+        for (i=0; i<8; i++) {
+            out[j]->limb[i] = in->limb[2*i][j] + (in->limb[2*i+1][j] << 28);
+        }
+        gf_weak_reduce(out[j]);
+    }
+}
@@ -0,0 +1,231 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+#include "field8.h"
+#include "f_dispatch.h"
+
+#if !GF8_VECTORIZED
+#error "The eight-way field arithmetic needs AVX-512 IFMA support in the compiler"
+#endif
+
+/* Only this file is built for AVX-512; callers check gf8_supported() first. */
+#define GF8_TARGET __attribute__((target("avx512f,avx512ifma")))
+
+#if (defined(__OPTIMIZE__) && !defined(__OPTIMIZE_SIZE__) && !I_HATE_UNROLLED_LOOPS) \
+     || defined(GOLDILOCKS_FORCE_UNROLL)
+#define REPEAT9(_x) _x _x _x _x _x _x _x _x _x
+#define FOR_LIMB(_i,_start,_end,_x) do { _i=_start; REPEAT9( if (_i<_end) { _x; } _i++;) } while (0)
+#else
+#define FOR_LIMB(_i,_start,_end,_x) do { for (_i=_start; _i<_end; _i++) _x; } while (0)
+#endif
+
+#define MASK52 ((1ull<<52)-1)
+#define MASK56 ((1ull<<56)-1)
+#define MASK32 ((1ull<<32)-1)
+
+/* 4p, radix 2^52 */
+static const uint64_t P4[9] = {
+    0xffffffffffffcull, 0xfffffffffffffull, 0xfffffffffffffull,
+    0xfffffffffffffull, 0xffffffffbffffull, 0xfffffffffffffull,
+    0xfffffffffffffull, 0xfffffffffffffull, 0x3ffffffffull
+};
+
+static GF8_TARGET GOLDILOCKS_INLINE uint64x8_t splat8(uint64_t x) {
+    uint64x8_t ret = {x,x,x,x,x,x,x,x};
+    return ret;
+}
+
+/* acc + low 52 bits of a*b */
+static GF8_TARGET GOLDILOCKS_INLINE uint64x8_t
+madd52lo(uint64x8_t acc, uint64x8_t a, uint64x8_t b) {
+    return (uint64x8_t)_mm512_madd52lo_epu64((__m512i)acc, (__m512i)a, (__m512i)b);
+}
+
+/* acc + high 52 bits of a*b */
+static GF8_TARGET GOLDILOCKS_INLINE uint64x8_t
+madd52hi(uint64x8_t acc, uint64x8_t a, uint64x8_t b) {
+    return (uint64x8_t)_mm512_madd52hi_epu64((__m512i)acc, (__m512i)a, (__m512i)b);
+}
+
+/* c[0..1] += x << s, where 0 < s < 52 */
+static GF8_TARGET GOLDILOCKS_INLINE void
+add_shifted(uint64x8_t *c, uint64x8_t x, unsigned int s) {
+    c[0] += (x << s) & splat8(MASK52);
+    c[1] += x >> (52-s);
+}
+
+/*
+ * Fold columns top..9 of a product into columns 0..8.  Column k has weight
+ * 2^(52k) = 2^(52(k-9)+20) * 2^448 == 2^(52(k-9)+20) + 2^(52(k-5)+36), and
+ * going from the top down picks up what lands above column 8 on the way.
+ */
+static GF8_TARGET GOLDILOCKS_INLINE void fold(uint64x8_t *c, int top) {
+    int i;
+    FOR_LIMB(i,0,top-8,{
+        add_shifted(&c[top-i-9], c[top-i], 20);
+        add_shifted(&c[top-i-5], c[top-i], 36);
+    });
+}
+
+/* Signed carry chain, then wrap bits 448 and up around as 2^224+1 */
+static GF8_TARGET GOLDILOCKS_INLINE void carry(uint64x8_t *c) {
+    const uint64x8_t mask = splat8(MASK52);
+    uint64x8_t tmp;
+    int i;
+    FOR_LIMB(i,0,8,{
+        c[i+1] += (uint64x8_t)((int64x8_t)c[i] >> 52);
+        c[i] &= mask;
+    });
+    tmp = (uint64x8_t)((int64x8_t)c[8] >> 32);
+    c[8] &= splat8(MASK32);
+    c[0] += tmp;
+    c[4] += tmp << 16;
+    FOR_LIMB(i,0,8,{
+        c[i+1] += c[i] >> 52;
+        c[i] &= mask;
+    });
+}
+
+int gf8_supported (void) {
+    return !!(goldilocks_cpu_features() & GOLDILOCKS_CPU_IFMA);
+}
+
+GF8_TARGET void gf8_weak_reduce (gf8 a) {
+    carry(a->limb);
+}
+
+GF8_TARGET void gf8_add (gf8 out, const gf8 a, const gf8 b) {
+    unsigned int i;
+    for (i=0; i<9; i++) {
+        out->limb[i] = a->limb[i] + b->limb[i];
+    }
+    carry(out->limb);
+}
+
+GF8_TARGET void gf8_sub (gf8 out, const gf8 a, const gf8 b) {
+    /* Bias by 4p, which is more than b; limbs may go negative until the carry */
+    unsigned int i;
+    for (i=0; i<9; i++) {
+        out->limb[i] = a->limb[i] - b->limb[i] + splat8(P4[i]);
+    }
+    carry(out->limb);
+}
+
+GF8_TARGET void gf8_mul (gf8_s *__restrict__ cs, const gf8 as, const gf8 bs) {
+    const uint64x8_t *a = as->limb, *b = bs->limb;
+    uint64x8_t c[18];
+    int i,j;
+
+    FOR_LIMB(i,0,9,{ c[i] = c[i+9] = splat8(0); });
+
+    FOR_LIMB(i,0,9,{
+        FOR_LIMB(j,0,9,{
+            c[i+j]   = madd52lo(c[i+j],   a[i], b[j]);
+            c[i+j+1] = madd52hi(c[i+j+1], a[i], b[j]);
+        });
+    });
+
+    fold(c,17);
+    carry(c);
+    FOR_LIMB(i,0,9,{ cs->limb[i] = c[i]; });
+}
+
+GF8_TARGET void gf8_sqr (gf8_s *__restrict__ cs, const gf8 as) {
+    const uint64x8_t *a = as->limb;
+    uint64x8_t c[18];
+    int i,j;
+
+    FOR_LIMB(i,0,9,{ c[i] = c[i+9] = splat8(0); });
+
+    /* Cross terms once, then double them */
+    FOR_LIMB(i,0,9,{
+        FOR_LIMB(j,i+1,9,{
+            c[i+j]   = madd52lo(c[i+j],   a[i], a[j]);
+            c[i+j+1] = madd52hi(c[i+j+1], a[i], a[j]);
+        });
+    });
+    FOR_LIMB(i,0,9,{ c[i] += c[i]; c[i+9] += c[i+9]; });
+    FOR_LIMB(i,0,9,{
+        c[2*i]   = madd52lo(c[2*i],   a[i], a[i]);
+        c[2*i+1] = madd52hi(c[2*i+1], a[i], a[i]);
+    });
+
+    fold(c,17);
+    carry(c);
+    FOR_LIMB(i,0,9,{ cs->limb[i] = c[i]; });
+}
+
+GF8_TARGET void gf8_mulw_unsigned (gf8_s *__restrict__ cs, const gf8 as, uint32_t w) {
+    const uint64x8_t *a = as->limb, b = splat8(w);
+    uint64x8_t c[10];
+    int i;
+
+    c[9] = splat8(0);
+    FOR_LIMB(i,0,9,{ c[i] = splat8(0); });
+    FOR_LIMB(i,0,9,{
+        c[i]   = madd52lo(c[i],   a[i], b);
+        c[i+1] = madd52hi(c[i+1], a[i], b);
+    });
+
+    fold(c,9);
+    carry(c);
+    FOR_LIMB(i,0,9,{ cs->limb[i] = c[i]; });
+}
+
+GF8_TARGET void gf8_cond_swap (gf8 x, gf8_s *__restrict__ y, const mask_t swap[8]) {
+    const uint64x8_t m = {
+        swap[0], swap[1], swap[2], swap[3], swap[4], swap[5], swap[6], swap[7]
+    };
+    unsigned int i;
+    for (i=0; i<9; i++) {
+        uint64x8_t s = (x->limb[i] ^ y->limb[i]) & m;
+        x->limb[i] ^= s;
+        y->limb[i] ^= s;
+    }
+}
+
+/* The conversions only move bits around, so they don't need the wide unit */
+
+void gf8_load (gf8 out, const gf_s in[8]) {
+    gf t;
+    dword_t acc;
+    unsigned int i, j, k, bits;
+    for (j=0; j<8; j++) {
+        gf_copy(t,&in[j]);
+        gf_weak_reduce(t);
+        acc = 0;
+        bits = 0;
+        k = 0;
+        for (i=0; i<8; i++) {
+            acc += (dword_t)t->limb[i] << bits;
+            for (bits += 56; bits >= 52 && k < 8; bits -= 52) {
+                out->limb[k++][j] = (uint64_t)acc & MASK52;
+                acc >>= 52;
+            }
+        }
+        out->limb[8][j] = (uint64_t)acc;
+    }
+    goldilocks_bzero(t,sizeof(t));
+}
+
+void gf8_store (gf_s out[8], const gf8 in) {
+    dword_t acc;
+    unsigned int i, j, k, bits;
+    for (j=0; j<8; j++) {
+        acc = 0;
+        bits = 0;
+        k = 0;
+        for (i=0; i<9; i++) {
+            acc += (dword_t)in->limb[i][j] << bits;
+            for (bits += 52; bits >= 56 && k < 8; bits -= 56) {
+                out[j].limb[k++] = (uint64_t)acc & MASK56;
+                acc >>= 56;
+            }
+        }
+        /* What is left is above 2^448 */
+        out[j].limb[0] += (uint64_t)acc;
+        out[j].limb[4] += (uint64_t)acc;
+        gf_weak_reduce(&out[j]);
+    }
+}
@@ -0,0 +1,9 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+/* The multipliers from f_impl.c again, using mulx, for the runtime dispatch build. */
+#define GOLDILOCKS_WIDEMUL_MULX 1
+#define GF_IMPL_NAME(x) x##_bmi2
+
+#include "f_impl.c"
@@ -0,0 +1,360 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+#include "f_field.h"
+
+/*
+ * Both gf_mul and gf_sqr leave the low half t[0..6] of the product in
+ * out->limb and the high half t[7..13] in r15, r8..r13, then reduce in
+ * registers.  Split t_hi = x + 2^224 y, so that
+ *     t_hi * 2^448 = t_hi (2^224 + 1) == (x + y) + 2^224 (x + 2y) mod p,
+ * which fits in seven limbs plus a few bits, and fold those in as 2^224+1.
+ */
+#define REDUCE_ASM \
+    /* y = t[10..13] >> 32; t[10] becomes x3 */ \
+    "movq %%r10, %%rax;" "shrdq $32, %%r11, %%rax;" \
+    "movq %%r11, %%rcx;" "shrdq $32, %%r12, %%rcx;" \
+    "movq %%r12, %%rdx;" "shrdq $32, %%r13, %%rdx;" \
+    "movq %%r13, %%r14;" "shrq $32, %%r14;" \
+    "movl %%r10d, %%r10d;" \
+    /* s = x + y, u = s + y */ \
+    "addq %%rax, %%r15;" "adcq %%rcx, %%r8;" "adcq %%rdx, %%r9;" "adcq %%r14, %%r10;" \
+    "addq %%r15, %%rax;" "adcq %%r8, %%rcx;" "adcq %%r9, %%rdx;" "adcq %%r10, %%r14;" \
+    /* u << 32 */ \
+    "movq %%rcx, %%r11;" "shldq $32, %%rax, %%r11;" \
+    "movq %%rdx, %%r12;" "shldq $32, %%rcx, %%r12;" \
+    "movq %%r14, %%r13;" "shldq $32, %%rdx, %%r13;" \
+    "shrq $32, %%r14;" "shlq $32, %%rax;" \
+    /* t_lo + s + 2^224 u, with the carries from both sums in CF and OF */ \
+    "xorl %%ecx, %%ecx;" \
+    "adcxq 0(%[c]), %%r15;" \
+    "adcxq 8(%[c]), %%r8;" \
+    "adcxq 16(%[c]), %%r9;" \
+    "adcxq 24(%[c]), %%r10;" "adoxq %%rax, %%r10;" \
+    "adcxq 32(%[c]), %%r11;" "adoxq %%rcx, %%r11;" \
+    "adcxq 40(%[c]), %%r12;" "adoxq %%rcx, %%r12;" \
+    "adcxq 48(%[c]), %%r13;" "adoxq %%rcx, %%r13;" \
+    "adcxq %%rcx, %%r14;" "adoxq %%rcx, %%r14;" \
+    /* fold what is above 2^448 back in, twice */ \
+    "movq %%r14, %%rdx;" "shlq $32, %%rdx;" \
+    "addq %%r14, %%r15;" "adcq $0, %%r8;" "adcq $0, %%r9;" "adcq %%rdx, %%r10;" \
+    "adcq $0, %%r11;" "adcq $0, %%r12;" "adcq $0, %%r13;" \
+    "movl $0, %%r14d;" "adcq $0, %%r14;" \
+    "movq %%r14, %%rdx;" "shlq $32, %%rdx;" \
+    "addq %%r14, %%r15;" "adcq $0, %%r8;" "adcq $0, %%r9;" "adcq %%rdx, %%r10;" \
+    "adcq $0, %%r11;" "adcq $0, %%r12;" "adcq $0, %%r13;" \
+    "movq %%r15, 0(%[c]);" "movq %%r8, 8(%[c]);" "movq %%r9, 16(%[c]);" "movq %%r10, 24(%[c]);" \
+    "movq %%r11, 32(%[c]);" "movq %%r12, 40(%[c]);" "movq %%r13, 48(%[c]);"
+
+/*
+ * Schoolbook by rows.  Each row runs two carry chains at once: adcx for
+ * the low halves of the products, adox for the high halves.  r8..r15 hold
+ * a sliding window of eight columns.
+ */
+void gf_mul (gf_s *__restrict__ cs, const gf as, const gf bs) {
+    __asm__ volatile (
+        "xorl %%r8d, %%r8d;"   "xorl %%r9d, %%r9d;"   "xorl %%r10d, %%r10d;" "xorl %%r11d, %%r11d;"
+        "xorl %%r12d, %%r12d;" "xorl %%r13d, %%r13d;" "xorl %%r14d, %%r14d;"
+
+        /* row 0 */
+        "movq 0(%[a]), %%rdx;"
+        "xorl %%r15d, %%r15d;"
+        "mulxq 0(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "mulxq 8(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "mulxq 16(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "mulxq 24(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "mulxq 32(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "mulxq 40(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 48(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "adcq $0, %%r15;"
+        "movq %%r8, 0(%[c]);"
+
+        /* row 1 */
+        "movq 8(%[a]), %%rdx;"
+        "xorl %%r8d, %%r8d;"
+        "mulxq 0(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "mulxq 8(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "mulxq 16(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "mulxq 24(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "mulxq 32(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 40(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 48(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "adcq $0, %%r8;"
+        "movq %%r9, 8(%[c]);"
+
+        /* row 2 */
+        "movq 16(%[a]), %%rdx;"
+        "xorl %%r9d, %%r9d;"
+        "mulxq 0(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "mulxq 8(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "mulxq 16(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "mulxq 24(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 32(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 40(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "mulxq 48(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "adcq $0, %%r9;"
+        "movq %%r10, 16(%[c]);"
+
+        /* row 3 */
+        "movq 24(%[a]), %%rdx;"
+        "xorl %%r10d, %%r10d;"
+        "mulxq 0(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "mulxq 8(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "mulxq 16(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 24(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 32(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "mulxq 40(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "mulxq 48(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "adcq $0, %%r10;"
+        "movq %%r11, 24(%[c]);"
+
+        /* row 4 */
+        "movq 32(%[a]), %%rdx;"
+        "xorl %%r11d, %%r11d;"
+        "mulxq 0(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "mulxq 8(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 16(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 24(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "mulxq 32(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "mulxq 40(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "mulxq 48(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "adcq $0, %%r11;"
+        "movq %%r12, 32(%[c]);"
+
+        /* row 5 */
+        "movq 40(%[a]), %%rdx;"
+        "xorl %%r12d, %%r12d;"
+        "mulxq 0(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 8(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 16(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "mulxq 24(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "mulxq 32(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "mulxq 40(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "mulxq 48(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "adcq $0, %%r12;"
+        "movq %%r13, 40(%[c]);"
+
+        /* row 6 */
+        "movq 48(%[a]), %%rdx;"
+        "xorl %%r13d, %%r13d;"
+        "mulxq 0(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 8(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "mulxq 16(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "mulxq 24(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "mulxq 32(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "mulxq 40(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "mulxq 48(%[b]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "adcq $0, %%r13;"
+        "movq %%r14, 48(%[c]);"
+
+        REDUCE_ASM
+        :
+        : [a]"r"(as->limb), [b]"r"(bs->limb), [c]"r"(cs->limb)
+        : "rax", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+          "cc", "memory"
+    );
+}
+
+/*
+ * The products a[i]*a[j] for i<j by rows as in gf_mul, then one pass which
+ * doubles them (adcx) and adds the squares (adox).
+ */
+void gf_sqr (gf_s *__restrict__ cs, const gf as) {
+    __asm__ volatile (
+        "xorl %%r8d, %%r8d;"   "xorl %%r9d, %%r9d;"   "xorl %%r10d, %%r10d;" "xorl %%r11d, %%r11d;"
+        "xorl %%r12d, %%r12d;" "xorl %%r13d, %%r13d;" "xorl %%r14d, %%r14d;"
+
+        /* row 0 */
+        "movq 0(%[a]), %%rdx;"
+        "xorl %%r15d, %%r15d;"
+        "mulxq 8(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "mulxq 16(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "mulxq 24(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "mulxq 32(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "mulxq 40(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 48(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "adcq $0, %%r15;"
+        "movq %%r8, 0(%[c]);"
+
+        /* row 1 */
+        "movq 8(%[a]), %%rdx;"
+        "xorl %%r8d, %%r8d;"
+        "mulxq 16(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "mulxq 24(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r12;" "adoxq %%rcx, %%r13;"
+        "mulxq 32(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 40(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 48(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "adcq $0, %%r8;"
+        "movq %%r9, 8(%[c]);"
+
+        /* row 2 */
+        "movq 16(%[a]), %%rdx;"
+        "xorl %%r9d, %%r9d;"
+        "mulxq 24(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r13;" "adoxq %%rcx, %%r14;"
+        "mulxq 32(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r14;" "adoxq %%rcx, %%r15;"
+        "mulxq 40(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "mulxq 48(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "adcq $0, %%r9;"
+        "movq %%r10, 16(%[c]);"
+
+        /* row 3 */
+        "movq 24(%[a]), %%rdx;"
+        "xorl %%r10d, %%r10d;"
+        "mulxq 32(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r15;" "adoxq %%rcx, %%r8;"
+        "mulxq 40(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r8;" "adoxq %%rcx, %%r9;"
+        "mulxq 48(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "adcq $0, %%r10;"
+        "movq %%r11, 24(%[c]);"
+
+        /* row 4 */
+        "movq 32(%[a]), %%rdx;"
+        "xorl %%r11d, %%r11d;"
+        "mulxq 40(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r9;" "adoxq %%rcx, %%r10;"
+        "mulxq 48(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r10;" "adoxq %%rcx, %%r11;"
+        "adcq $0, %%r11;"
+        "movq %%r12, 32(%[c]);"
+
+        /* row 5 */
+        "movq 40(%[a]), %%rdx;"
+        "xorl %%r12d, %%r12d;"
+        "mulxq 48(%[a]), %%rax, %%rcx;"
+        "adcxq %%rax, %%r11;" "adoxq %%rcx, %%r12;"
+        "adcq $0, %%r12;"
+        "movq %%r13, 40(%[c]);"
+
+        /* row 6 */
+        "xorl %%r13d, %%r13d;"
+        "movq %%r14, 48(%[c]);"
+
+        /* double and add the squares */
+        "xorl %%r14d, %%r14d;"
+        "movq 0(%[a]), %%rdx;"
+        "mulxq %%rdx, %%rax, %%rcx;"
+        "movq 0(%[c]), %%r14;"
+        "adcxq %%r14, %%r14;" "adoxq %%rax, %%r14;"
+        "movq %%r14, 0(%[c]);"
+        "movq 8(%[c]), %%r14;"
+        "adcxq %%r14, %%r14;" "adoxq %%rcx, %%r14;"
+        "movq %%r14, 8(%[c]);"
+        "movq 8(%[a]), %%rdx;"
+        "mulxq %%rdx, %%rax, %%rcx;"
+        "movq 16(%[c]), %%r14;"
+        "adcxq %%r14, %%r14;" "adoxq %%rax, %%r14;"
+        "movq %%r14, 16(%[c]);"
+        "movq 24(%[c]), %%r14;"
+        "adcxq %%r14, %%r14;" "adoxq %%rcx, %%r14;"
+        "movq %%r14, 24(%[c]);"
+        "movq 16(%[a]), %%rdx;"
+        "mulxq %%rdx, %%rax, %%rcx;"
+        "movq 32(%[c]), %%r14;"
+        "adcxq %%r14, %%r14;" "adoxq %%rax, %%r14;"
+        "movq %%r14, 32(%[c]);"
+        "movq 40(%[c]), %%r14;"
+        "adcxq %%r14, %%r14;" "adoxq %%rcx, %%r14;"
+        "movq %%r14, 40(%[c]);"
+        "movq 24(%[a]), %%rdx;"
+        "mulxq %%rdx, %%rax, %%rcx;"
+        "movq 48(%[c]), %%r14;"
+        "adcxq %%r14, %%r14;" "adoxq %%rax, %%r14;"
+        "movq %%r14, 48(%[c]);"
+        "adcxq %%r15, %%r15;" "adoxq %%rcx, %%r15;"
+        "movq 32(%[a]), %%rdx;"
+        "mulxq %%rdx, %%rax, %%rcx;"
+        "adcxq %%r8, %%r8;" "adoxq %%rax, %%r8;"
+        "adcxq %%r9, %%r9;" "adoxq %%rcx, %%r9;"
+        "movq 40(%[a]), %%rdx;"
+        "mulxq %%rdx, %%rax, %%rcx;"
+        "adcxq %%r10, %%r10;" "adoxq %%rax, %%r10;"
+        "adcxq %%r11, %%r11;" "adoxq %%rcx, %%r11;"
+        "movq 48(%[a]), %%rdx;"
+        "mulxq %%rdx, %%rax, %%rcx;"
+        "adcxq %%r12, %%r12;" "adoxq %%rax, %%r12;"
+        "adcxq %%r13, %%r13;" "adoxq %%rcx, %%r13;"
+
+        REDUCE_ASM
+        :
+        : [a]"r"(as->limb), [c]"r"(cs->limb)
+        : "rax", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+          "cc", "memory"
+    );
+}
+
+void gf_mulw_unsigned (gf_s *__restrict__ cs, const gf as, uint32_t b) {
+    dword_t acc = 0;
+    unsigned int i;
+    for (i=0; i<7; i++) {
+        acc = (acc>>64) + widemul(as->limb[i], b);
+        cs->limb[i] = acc;
+    }
+    gf_fold_top(cs, acc>>64);
+}
@@ -0,0 +1,77 @@
+/* Copyright (c) 2018 the libgoldilocks contributors.
+ * Released under the MIT License.  See LICENSE.txt for license information.
+ */
+
+/*
+ * Saturated representation: 7 full 64-bit limbs, always below 2^448 but
+ * not necessarily below p.  Every operation reduces, so there is no
+ * headroom to track and gf_bias and gf_weak_reduce do nothing.
+ */
+
+#define GF_HEADROOM 9999 /* Everything is reduced anyway */
+#define FIELD_LITERAL(a,b,c,d,e,f,g,h) {{ \
+    (uint64_t)(a)     | (uint64_t)(b)<<56, (uint64_t)(b)>>8  | (uint64_t)(c)<<48, \
+    (uint64_t)(c)>>16 | (uint64_t)(d)<<40, (uint64_t)(d)>>24 | (uint64_t)(e)<<32, \
+    (uint64_t)(e)>>32 | (uint64_t)(f)<<24, (uint64_t)(f)>>40 | (uint64_t)(g)<<16, \
+    (uint64_t)(g)>>48 | (uint64_t)(h)<<8 }}
+
+#define LIMB_PLACE_VALUE(i) 64
+#define LIMB_MASK(i) (~(uint64_t)0)
+
+/* a += top * 2^448 = top * (2^224 + 1), for small top */
+static INLINE_UNUSED void gf_fold_top (gf a, uint64_t top) {
+    dword_t acc;
+    int j;
+    for (j=0; j<2; j++) {
+        acc = (dword_t)a->limb[0] + top;                a->limb[0] = acc;
+        acc = (acc>>64) + a->limb[1];                   a->limb[1] = acc;
+        acc = (acc>>64) + a->limb[2];                   a->limb[2] = acc;
+        acc = (acc>>64) + a->limb[3] + (top<<32);       a->limb[3] = acc;
+        acc = (acc>>64) + a->limb[4];                   a->limb[4] = acc;
+        acc = (acc>>64) + a->limb[5];                   a->limb[5] = acc;
+        acc = (acc>>64) + a->limb[6];                   a->limb[6] = acc;
+        /* The second time round this is 0: the first carry leaves a small value */
+        top = acc>>64;
+    }
+}
+
+void gf_add_RAW (gf out, const gf a, const gf b) {
+    dword_t acc = 0;
+    unsigned int i;
+    for (i=0; i<7; i++) {
+        acc = (acc>>64) + a->limb[i] + b->limb[i];
+        out->limb[i] = acc;
+    }
+    gf_fold_top(out, acc>>64);
+}
+
+void gf_sub_RAW (gf out, const gf a, const gf b) {
+    dsword_t acc = 0;
+    uint64_t borrow;
+    unsigned int i;
+    int j;
+    for (i=0; i<7; i++) {
+        acc = (acc>>64) + a->limb[i] - b->limb[i];
+        out->limb[i] = acc;
+    }
+    /* On a borrow we are 2^448 too high: take off 2^224+1, maybe twice */
+    borrow = acc>>64;
+    for (j=0; j<2; j++) {
+        acc = (dsword_t)out->limb[0] - (borrow & 1);
+        out->limb[0] = acc;
+        for (i=1; i<7; i++) {
+            acc = (acc>>64) + out->limb[i] - ((i==3) ? borrow & (1ull<<32) : 0);
+            out->limb[i] = acc;
+        }
+        borrow = acc>>64;
+    }
+}
+
+void gf_bias (gf a, int amt) {
+    (void) a;
+    (void) amt;
+}
+
+void gf_weak_reduce (gf a) {
+    (void) a;
+}
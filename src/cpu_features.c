@@ -0,0 +1,60 @@
+/**
+ * @file cpu_features.c
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * @brief Run-time CPU feature detection.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_features.h"
+
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+
+static unsigned int cpu_detect (void) {
+    unsigned int features = 0;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("bmi2")) features |= GOLDILOCKS_CPU_BMI2;
+    if (__builtin_cpu_supports("avx2")) features |= GOLDILOCKS_CPU_AVX2;
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma")) {
+        features |= GOLDILOCKS_CPU_IFMA;
+    }
+    if (__builtin_cpu_supports("avx512f")) features |= GOLDILOCKS_CPU_AVX512;
+    return features;
+}
+
+static unsigned int cpu_limit (void) {
+    const char *env = getenv("GOLDILOCKS_CPU");
+    if (env == NULL || !*env) return -1u;
+    if (!strcmp(env,"bmi2")) return GOLDILOCKS_CPU_BMI2;
+    if (!strcmp(env,"avx2")) return GOLDILOCKS_CPU_BMI2 | GOLDILOCKS_CPU_AVX2;
+    if (!strcmp(env,"avx512")) {
+        return GOLDILOCKS_CPU_BMI2 | GOLDILOCKS_CPU_AVX2 | GOLDILOCKS_CPU_AVX512;
+    }
+    if (!strcmp(env,"avx512ifma")) {
+        return GOLDILOCKS_CPU_BMI2 | GOLDILOCKS_CPU_AVX2 | GOLDILOCKS_CPU_AVX512 | GOLDILOCKS_CPU_IFMA;
+    }
+    return 0; /* "generic", or a typo: either way, don't turn anything on */
+}
+
+unsigned int goldilocks_cpu_features (void) {
+    /* Racing threads all compute the same thing, so this needs no lock */
+    static int features = -1;
+    int ret = __atomic_load_n(&features, __ATOMIC_RELAXED);
+    if (ret < 0) {
+        ret = (int)(cpu_detect() & cpu_limit());
+        __atomic_store_n(&features, ret, __ATOMIC_RELAXED);
+    }
+    return ret;
+}
+
+#else
+
+unsigned int goldilocks_cpu_features (void) {
+    return 0;
+}
+
+#endif
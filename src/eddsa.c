@@ -20,6 +20,7 @@
 #define hash_init    goldilocks_shake256_init
 #define hash_update  goldilocks_shake256_update
 #define hash_final   goldilocks_shake256_final
+#define hash_output  goldilocks_shake256_output
 #define hash_destroy goldilocks_shake256_destroy
 #define hash_hash    goldilocks_shake256_hash
 
@@ -94,24 +95,15 @@ void goldilocks_ed448_convert_private_key_to_x448 (
     );
 }
 
-/* Specially for libotrv4 */
-void goldilocks_ed448_derive_secret_scalar (
+/* Clamp and decode the hash of a private key into its secret scalar */
+static void hashed_key_to_secret_scalar (
     API_NS(scalar_p) secret,
-    const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
+    uint8_t secret_scalar_ser[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
 ) {
     unsigned int c;
-    /* only this much used for keygen */
-    uint8_t secret_scalar_ser[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
-
-    hash_hash(
-        secret_scalar_ser,
-        sizeof(secret_scalar_ser),
-        privkey,
-        GOLDILOCKS_EDDSA_448_PRIVATE_BYTES
-    );
     clamp(secret_scalar_ser);
 
-    API_NS(scalar_decode_long)(secret, secret_scalar_ser, sizeof(secret_scalar_ser));
+    API_NS(scalar_decode_long)(secret, secret_scalar_ser, GOLDILOCKS_EDDSA_448_PRIVATE_BYTES);
 
     /* Since we are going to mul_by_cofactor during encoding, divide by it here.
      * However, the EdDSA base point is not the same as the decaf base point if
@@ -122,6 +114,23 @@ void goldilocks_ed448_derive_secret_scalar (
     for (c=1; c < GOLDILOCKS_448_EDDSA_ENCODE_RATIO; c <<= 1) {
         API_NS(scalar_halve)(secret,secret);
     }
+}
+
+/* Specially for libotrv4 */
+void goldilocks_ed448_derive_secret_scalar (
+    API_NS(scalar_p) secret,
+    const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
+) {
+    /* only this much used for keygen */
+    uint8_t secret_scalar_ser[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
+
+    hash_hash(
+        secret_scalar_ser,
+        sizeof(secret_scalar_ser),
+        privkey,
+        GOLDILOCKS_EDDSA_448_PRIVATE_BYTES
+    );
+    hashed_key_to_secret_scalar(secret, secret_scalar_ser);
 
     goldilocks_bzero(secret_scalar_ser, sizeof(secret_scalar_ser));
 }
@@ -143,42 +152,118 @@ void goldilocks_ed448_derive_public_key (
     API_NS(point_destroy)(p);
 }
 
-void goldilocks_ed448_sign (
+/* Keys per block of goldilocks_ed448_derive_public_key_batch */
+#define KEYGEN_BATCH_MAX 64
+
+void goldilocks_ed448_derive_public_key_batch (
+    uint8_t *pubkey,
+    const uint8_t *privkey,
+    size_t n
+) {
+    uint8_t ser[4][GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
+    uint8_t *const outs[4] = { ser[0], ser[1], ser[2], ser[3] };
+    API_NS(scalar_p) secret[KEYGEN_BATCH_MAX];
+    API_NS(point_p) p[KEYGEN_BATCH_MAX];
+    size_t i, j, k, m;
+
+    for (i=0; i<n; i+=m) {
+        m = (n-i < KEYGEN_BATCH_MAX) ? n-i : KEYGEN_BATCH_MAX;
+
+        /* Hash the keys four at a time, and any left over one at a time */
+        for (j=0; j+4<=m; j+=4) {
+            const uint8_t *const ins[4] = {
+                &privkey[(i+j)*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES],
+                &privkey[(i+j+1)*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES],
+                &privkey[(i+j+2)*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES],
+                &privkey[(i+j+3)*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
+            };
+            goldilocks_shake256_x4_hash(outs, sizeof(ser[0]), ins, GOLDILOCKS_EDDSA_448_PRIVATE_BYTES);
+            for (k=0; k<4; k++) hashed_key_to_secret_scalar(secret[j+k], ser[k]);
+        }
+        for (; j<m; j++) {
+            goldilocks_ed448_derive_secret_scalar(secret[j], &privkey[(i+j)*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]);
+        }
+
+        for (j=0; j<m; j++) {
+            API_NS(precomputed_scalarmul)(p[j], API_NS(precomputed_base), secret[j]);
+        }
+        API_NS(point_mul_by_ratio_and_encode_like_eddsa_batch)(
+            &pubkey[i*GOLDILOCKS_EDDSA_448_PUBLIC_BYTES], (const API_NS(point_p) *)p, m);
+    }
+
+    /* Cleanup */
+    goldilocks_bzero(ser, sizeof(ser));
+    goldilocks_bzero(secret, sizeof(secret));
+    goldilocks_bzero(p, sizeof(p));
+}
+
+/* Hash the private key into the secret scalar and the nonce seed. */
+static void expand_secret (
+    goldilocks_ed448_expanded_key_p expanded,
+    const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
+) {
+    struct {
+        uint8_t secret_scalar_ser[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
+        uint8_t seed[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
+    } __attribute__((packed)) ser;
+    hash_hash(
+        (uint8_t *)&ser,
+        sizeof(ser),
+        privkey,
+        GOLDILOCKS_EDDSA_448_PRIVATE_BYTES
+    );
+    clamp(ser.secret_scalar_ser);
+    API_NS(scalar_decode_long)(expanded->secret_scalar, ser.secret_scalar_ser, sizeof(ser.secret_scalar_ser));
+    memcpy(expanded->seed, ser.seed, sizeof(expanded->seed));
+    goldilocks_bzero(&ser, sizeof(ser));
+}
+
+void goldilocks_ed448_expand_private_key (
+    goldilocks_ed448_expanded_key_p expanded,
+    const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
+) {
+    unsigned int c;
+    API_NS(scalar_p) secret_scalar;
+    API_NS(point_p) p;
+    expand_secret(expanded, privkey);
+
+    /* Same as goldilocks_ed448_derive_public_key, without hashing again */
+    API_NS(scalar_halve)(secret_scalar, expanded->secret_scalar);
+    for (c = 2; c < GOLDILOCKS_448_EDDSA_ENCODE_RATIO; c <<= 1) {
+        API_NS(scalar_halve)(secret_scalar, secret_scalar);
+    }
+
+    API_NS(precomputed_scalarmul)(p,API_NS(precomputed_base),secret_scalar);
+    API_NS(point_mul_by_ratio_and_encode_like_eddsa)(expanded->pubkey, p);
+
+    API_NS(scalar_destroy)(secret_scalar);
+    API_NS(point_destroy)(p);
+}
+
+void goldilocks_ed448_expanded_key_destroy (
+    goldilocks_ed448_expanded_key_p expanded
+) {
+    goldilocks_bzero(expanded, sizeof(goldilocks_ed448_expanded_key_s));
+}
+
+void goldilocks_ed448_sign_expanded (
     uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
-    const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES],
-    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const goldilocks_ed448_expanded_key_p expanded,
     const uint8_t *message,
     size_t message_len,
     uint8_t prehashed,
     const uint8_t *context,
     uint8_t context_len
 ) {
-    API_NS(scalar_p) secret_scalar;
     hash_ctx_p hash;
     API_NS(scalar_p) nonce_scalar;
     uint8_t nonce_point[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES] = {0};
     API_NS(scalar_p) challenge_scalar;
-    {
-        /* Schedule the secret key */
-        struct {
-            uint8_t secret_scalar_ser[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
-            uint8_t seed[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
-        } __attribute__((packed)) expanded;
-        hash_hash(
-            (uint8_t *)&expanded,
-            sizeof(expanded),
-            privkey,
-            GOLDILOCKS_EDDSA_448_PRIVATE_BYTES
-        );
-        clamp(expanded.secret_scalar_ser);
-        API_NS(scalar_decode_long)(secret_scalar, expanded.secret_scalar_ser, sizeof(expanded.secret_scalar_ser));
-
-        /* Hash to create the nonce */
-        hash_init_with_dom(hash,prehashed,0,context,context_len);
-        hash_update(hash,expanded.seed,sizeof(expanded.seed));
-        hash_update(hash,message,message_len);
-        goldilocks_bzero(&expanded, sizeof(expanded));
-    }
+
+    /* Hash to create the nonce */
+    hash_init_with_dom(hash,prehashed,0,context,context_len);
+    hash_update(hash,expanded->seed,sizeof(expanded->seed));
+    hash_update(hash,message,message_len);
 
     /* Decode the nonce */
     {
@@ -209,7 +294,7 @@ void goldilocks_ed448_sign (
         /* Compute the challenge */
         hash_init_with_dom(hash,prehashed,0,context,context_len);
         hash_update(hash,nonce_point,sizeof(nonce_point));
-        hash_update(hash,pubkey,GOLDILOCKS_EDDSA_448_PUBLIC_BYTES);
+        hash_update(hash,expanded->pubkey,sizeof(expanded->pubkey));
         hash_update(hash,message,message_len);
         hash_final(hash,challenge,sizeof(challenge));
         hash_destroy(hash);
@@ -217,18 +302,46 @@ void goldilocks_ed448_sign (
         goldilocks_bzero(challenge,sizeof(challenge));
     }
 
-    API_NS(scalar_mul)(challenge_scalar,challenge_scalar,secret_scalar);
+    API_NS(scalar_mul)(challenge_scalar,challenge_scalar,expanded->secret_scalar);
     API_NS(scalar_add)(challenge_scalar,challenge_scalar,nonce_scalar);
 
     goldilocks_bzero(signature,GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES);
     memcpy(signature,nonce_point,sizeof(nonce_point));
     API_NS(scalar_encode)(&signature[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],challenge_scalar);
 
-    API_NS(scalar_destroy)(secret_scalar);
     API_NS(scalar_destroy)(nonce_scalar);
     API_NS(scalar_destroy)(challenge_scalar);
 }
 
+void goldilocks_ed448_sign (
+    uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES],
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len
+) {
+    /* Schedule the secret key */
+    goldilocks_ed448_expanded_key_p expanded;
+    expand_secret(expanded, privkey);
+    memcpy(expanded->pubkey, pubkey, sizeof(expanded->pubkey));
+
+    goldilocks_ed448_sign_expanded(signature,expanded,message,message_len,prehashed,context,context_len);
+    goldilocks_ed448_expanded_key_destroy(expanded);
+}
+
+/* Finish a copy of the prehash, leaving the caller's context untouched. */
+static void prehash_output (
+    uint8_t hash_output[EDDSA_PREHASH_BYTES],
+    const goldilocks_ed448_prehash_ctx_p hash
+) {
+    goldilocks_ed448_prehash_ctx_p hash_too;
+    memcpy(hash_too,hash,sizeof(hash_too));
+    hash_final(hash_too,hash_output,EDDSA_PREHASH_BYTES);
+    hash_destroy(hash_too);
+}
 
 void goldilocks_ed448_sign_prehash (
     uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
@@ -239,18 +352,29 @@ void goldilocks_ed448_sign_prehash (
     uint8_t context_len
 ) {
     uint8_t hash_output[EDDSA_PREHASH_BYTES];
-    {
-        goldilocks_ed448_prehash_ctx_p hash_too;
-        memcpy(hash_too,hash,sizeof(hash_too));
-        hash_final(hash_too,hash_output,sizeof(hash_output));
-        hash_destroy(hash_too);
-    }
+    prehash_output(hash_output,hash);
 
     goldilocks_ed448_sign(signature,privkey,pubkey,hash_output,sizeof(hash_output),1,context,context_len);
     goldilocks_bzero(hash_output,sizeof(hash_output));
 }
 
-goldilocks_error_t goldilocks_ed448_verify (
+void goldilocks_ed448_sign_expanded_prehash (
+    uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const goldilocks_ed448_expanded_key_p expanded,
+    const goldilocks_ed448_prehash_ctx_p hash,
+    const uint8_t *context,
+    uint8_t context_len
+) {
+    uint8_t hash_output[EDDSA_PREHASH_BYTES];
+    prehash_output(hash_output,hash);
+
+    goldilocks_ed448_sign_expanded(signature,expanded,hash_output,sizeof(hash_output),1,context,context_len);
+    goldilocks_bzero(hash_output,sizeof(hash_output));
+}
+
+/* Compute the challenge H(dom || R || A || M) of a signature. */
+static void verify_challenge (
+    API_NS(scalar_p) challenge_scalar,
     const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
     const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
     const uint8_t *message,
@@ -259,31 +383,24 @@ goldilocks_error_t goldilocks_ed448_verify (
     const uint8_t *context,
     uint8_t context_len
 ) {
-    API_NS(point_p) pk_point, r_point;
-    API_NS(scalar_p) challenge_scalar;
-    API_NS(scalar_p) response_scalar;
-    unsigned  int c;
-    goldilocks_error_t error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(pk_point,pubkey);
-    if (GOLDILOCKS_SUCCESS != error) { return error; }
-
-    error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(r_point,signature);
-    if (GOLDILOCKS_SUCCESS != error) { return error; }
-
-    {
-        /* Compute the challenge */
-        hash_ctx_p hash;
-        uint8_t challenge[2*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
-        hash_init_with_dom(hash,prehashed,0,context,context_len);
-        hash_update(hash,signature,GOLDILOCKS_EDDSA_448_PUBLIC_BYTES);
-        hash_update(hash,pubkey,GOLDILOCKS_EDDSA_448_PUBLIC_BYTES);
-        hash_update(hash,message,message_len);
-        hash_final(hash,challenge,sizeof(challenge));
-        hash_destroy(hash);
-        API_NS(scalar_decode_long)(challenge_scalar,challenge,sizeof(challenge));
-        goldilocks_bzero(challenge,sizeof(challenge));
-    }
-    API_NS(scalar_sub)(challenge_scalar, API_NS(scalar_zero), challenge_scalar);
+    hash_ctx_p hash;
+    uint8_t challenge[2*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
+    hash_init_with_dom(hash,prehashed,0,context,context_len);
+    hash_update(hash,signature,GOLDILOCKS_EDDSA_448_PUBLIC_BYTES);
+    hash_update(hash,pubkey,GOLDILOCKS_EDDSA_448_PUBLIC_BYTES);
+    hash_update(hash,message,message_len);
+    hash_final(hash,challenge,sizeof(challenge));
+    hash_destroy(hash);
+    API_NS(scalar_decode_long)(challenge_scalar,challenge,sizeof(challenge));
+    goldilocks_bzero(challenge,sizeof(challenge));
+}
 
+/* Decode the response half of a signature, compensating for the decoding ratio. */
+static void verify_response (
+    API_NS(scalar_p) response_scalar,
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES]
+) {
+    unsigned int c;
     API_NS(scalar_decode_long)(
         response_scalar,
         &signature[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
@@ -293,18 +410,85 @@ goldilocks_error_t goldilocks_ed448_verify (
     for (c=1; c<GOLDILOCKS_448_EDDSA_DECODE_RATIO; c<<=1) {
         API_NS(scalar_add)(response_scalar,response_scalar,response_scalar);
     }
+}
+
+/* combo = (k*G - c*P) / divisor, for signature (R, k) and challenge c */
+static goldilocks_error_t verify_combination (
+    API_NS(point_p) combo,
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len,
+    unsigned int divisor
+) {
+    API_NS(scalar_p) challenge_scalar;
+    API_NS(scalar_p) response_scalar;
+    unsigned int c;
+    goldilocks_error_t error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(combo,pubkey);
+    if (GOLDILOCKS_SUCCESS != error) { return error; }
 
+    verify_challenge(challenge_scalar,signature,pubkey,message,message_len,prehashed,context,context_len);
+    API_NS(scalar_sub)(challenge_scalar, API_NS(scalar_zero), challenge_scalar);
+
+    verify_response(response_scalar,signature);
+
+    for (c=1; c<divisor; c<<=1) {
+        API_NS(scalar_halve)(challenge_scalar,challenge_scalar);
+        API_NS(scalar_halve)(response_scalar,response_scalar);
+    }
 
-    /* pk_point = -c(x(P)) + (cx + k)G = kG */
+    /* combo = -c(x(P)) + (cx + k)G = kG */
     API_NS(base_double_scalarmul_non_secret)(
-        pk_point,
+        combo,
         response_scalar,
-        pk_point,
+        combo,
         challenge_scalar
     );
-    return goldilocks_succeed_if(API_NS(point_eq(pk_point,r_point)));
+    return GOLDILOCKS_SUCCESS;
 }
 
+goldilocks_error_t goldilocks_ed448_verify (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len
+) {
+    API_NS(point_p) combo, r_point;
+    goldilocks_error_t error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(r_point,signature);
+    if (GOLDILOCKS_SUCCESS != error) { return error; }
+
+    error = verify_combination(combo,signature,pubkey,message,message_len,prehashed,context,context_len,1);
+    if (GOLDILOCKS_SUCCESS != error) { return error; }
+
+    return goldilocks_succeed_if(API_NS(point_eq(combo,r_point)));
+}
+
+goldilocks_error_t goldilocks_ed448_verify_strict (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len
+) {
+    API_NS(point_p) combo;
+    uint8_t r_enc[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES];
+
+    /* Encoding multiplies by the ratio, so divide it out of the scalars first */
+    goldilocks_error_t error = verify_combination(combo,signature,pubkey,message,message_len,
+        prehashed,context,context_len,GOLDILOCKS_448_EDDSA_ENCODE_RATIO);
+    if (GOLDILOCKS_SUCCESS != error) { return error; }
+
+    API_NS(point_mul_by_ratio_and_encode_like_eddsa)(r_enc,combo);
+    return goldilocks_succeed_if(goldilocks_memeq(r_enc,signature,sizeof(r_enc)));
+}
 
 goldilocks_error_t goldilocks_ed448_verify_prehash (
     const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
@@ -327,3 +511,257 @@ goldilocks_error_t goldilocks_ed448_verify_prehash (
 
     return ret;
 }
+
+goldilocks_error_t goldilocks_ed448_verify_strict_prehash (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const goldilocks_ed448_prehash_ctx_p hash,
+    const uint8_t *context,
+    uint8_t context_len
+) {
+    uint8_t hash_output[EDDSA_PREHASH_BYTES];
+    prehash_output(hash_output,hash);
+
+    return goldilocks_ed448_verify_strict(signature,pubkey,hash_output,sizeof(hash_output),1,context,context_len);
+}
+
+goldilocks_error_t goldilocks_ed448_prepare_public_key (
+    goldilocks_ed448_prepared_public_key_p prepared,
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES]
+) {
+    API_NS(point_p) pk_point;
+    goldilocks_error_t error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(pk_point,pubkey);
+    if (GOLDILOCKS_SUCCESS != error) { return error; }
+
+    /* Negated, because verification wants -c*A */
+    API_NS(point_negate)(pk_point,pk_point);
+    API_NS(precompute_wnaf)(prepared->table,pk_point);
+    memcpy(prepared->pubkey,pubkey,sizeof(prepared->pubkey));
+    return GOLDILOCKS_SUCCESS;
+}
+
+goldilocks_error_t goldilocks_ed448_verify_prepared (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const goldilocks_ed448_prepared_public_key_p prepared,
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len
+) {
+    API_NS(point_p) combo, r_point;
+    API_NS(scalar_p) challenge_scalar;
+    API_NS(scalar_p) response_scalar;
+    goldilocks_error_t error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(r_point,signature);
+    if (GOLDILOCKS_SUCCESS != error) { return error; }
+
+    verify_challenge(challenge_scalar,signature,prepared->pubkey,message,message_len,prehashed,context,context_len);
+    verify_response(response_scalar,signature);
+
+    /* combo = c(-x(P)) + (cx + k)G = kG */
+    API_NS(base_double_scalarmul_precomputed_non_secret)(
+        combo,
+        response_scalar,
+        prepared->table,
+        challenge_scalar
+    );
+    return goldilocks_succeed_if(API_NS(point_eq(combo,r_point)));
+}
+
+goldilocks_error_t goldilocks_ed448_verify_prepared_prehash (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const goldilocks_ed448_prepared_public_key_p prepared,
+    const goldilocks_ed448_prehash_ctx_p hash,
+    const uint8_t *context,
+    uint8_t context_len
+) {
+    uint8_t hash_output[EDDSA_PREHASH_BYTES];
+    prehash_output(hash_output,hash);
+
+    return goldilocks_ed448_verify_prepared(signature,prepared,hash_output,sizeof(hash_output),1,context,context_len);
+}
+
+/* Largest number of signatures combined into one multi-scalar multiply */
+#define VERIFY_BATCH_MAX 64
+
+/* Size of the random coefficients of the linear combination */
+#define VERIFY_BATCH_COEFFICIENT_BYTES 16
+
+/* Working space for one combined check: B, A_1 .. A_n, R_1 .. R_n */
+struct verify_batch_scratch {
+    API_NS(point_p) points[2*VERIFY_BATCH_MAX+1];
+    API_NS(scalar_p) scalars[2*VERIFY_BATCH_MAX+1];
+};
+
+static goldilocks_error_t verify_batch_item (
+    const goldilocks_ed448_verify_item_s *item
+) {
+    return goldilocks_ed448_verify(
+        item->signature,
+        item->pubkey,
+        item->message,
+        item->message_len,
+        item->prehashed,
+        item->context,
+        item->context_len
+    );
+}
+
+static goldilocks_error_t verify_batch_each (
+    const goldilocks_ed448_verify_item_s *items,
+    size_t n
+) {
+    size_t i;
+    for (i=0; i<n; i++) {
+        if (GOLDILOCKS_SUCCESS != verify_batch_item(&items[i])) return GOLDILOCKS_FAILURE;
+    }
+    return GOLDILOCKS_SUCCESS;
+}
+
+/* Check up to VERIFY_BATCH_MAX signatures with one random linear combination:
+ *   sum z_i (s_i B - k_i A_i - R_i) = 0
+ */
+static goldilocks_error_t verify_batch_combined (
+    struct verify_batch_scratch *scratch,
+    const goldilocks_ed448_verify_item_s *items,
+    size_t n
+) {
+    API_NS(point_p) *points, combo;
+    API_NS(scalar_p) *scalars, coefficient;
+    uint8_t coefficient_ser[VERIFY_BATCH_COEFFICIENT_BYTES];
+    uint8_t challenge_ser[GOLDILOCKS_448_SCALAR_BYTES];
+    const char *dom_s = "goldilocks_ed448_verify_batch";
+    goldilocks_error_t error = GOLDILOCKS_SUCCESS;
+    hash_ctx_p hash;
+    size_t i;
+
+    assert(n <= VERIFY_BATCH_MAX);
+    if (n == 1 || !scratch) return verify_batch_each(items,n);
+    points = scratch->points;
+    scalars = scratch->scalars;
+
+    /* The coefficients are derived from the whole batch, so that whoever
+     * chose the signatures can't predict them.
+     */
+    hash_init(hash);
+    hash_update(hash,(const unsigned char *)dom_s, strlen(dom_s));
+
+    /* Stash k_i and s_i in the scalars for now */
+    API_NS(point_copy)(points[0], API_NS(point_base));
+    for (i=0; i<n && error == GOLDILOCKS_SUCCESS; i++) {
+        const goldilocks_ed448_verify_item_s *item = &items[i];
+        error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(points[1+i],item->pubkey);
+        if (GOLDILOCKS_SUCCESS != error) break;
+        error = API_NS(point_decode_like_eddsa_and_mul_by_ratio)(points[1+n+i],item->signature);
+        if (GOLDILOCKS_SUCCESS != error) break;
+
+        verify_challenge(scalars[1+i],item->signature,item->pubkey,item->message,
+            item->message_len,item->prehashed,item->context,item->context_len);
+        verify_response(scalars[1+n+i],item->signature);
+
+        API_NS(scalar_encode)(challenge_ser,scalars[1+i]);
+        hash_update(hash,item->signature,GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES);
+        hash_update(hash,challenge_ser,sizeof(challenge_ser));
+    }
+
+    if (GOLDILOCKS_SUCCESS == error) {
+        /* Base scalar sum(z_i s_i); A_i gets -z_i k_i; R_i is negated so that
+         * its scalar z_i stays short.
+         */
+        API_NS(scalar_copy)(scalars[0], API_NS(scalar_zero));
+        for (i=0; i<n; i++) {
+            hash_output(hash,coefficient_ser,sizeof(coefficient_ser));
+            API_NS(scalar_decode_long)(coefficient,coefficient_ser,sizeof(coefficient_ser));
+
+            API_NS(scalar_mul)(scalars[1+n+i],scalars[1+n+i],coefficient);
+            API_NS(scalar_add)(scalars[0],scalars[0],scalars[1+n+i]);
+
+            API_NS(scalar_mul)(scalars[1+i],scalars[1+i],coefficient);
+            API_NS(scalar_sub)(scalars[1+i],API_NS(scalar_zero),scalars[1+i]);
+
+            API_NS(scalar_copy)(scalars[1+n+i],coefficient);
+            API_NS(point_negate)(points[1+n+i],points[1+n+i]);
+        }
+
+        if (GOLDILOCKS_SUCCESS == API_NS(point_multiscalarmul_non_secret)(
+            combo,
+            (const API_NS(point_p) *)points,
+            (const API_NS(scalar_p) *)scalars,
+            2*n+1
+        )) {
+            error = goldilocks_succeed_if(API_NS(point_eq)(combo,API_NS(point_identity)));
+        } else {
+            /* Out of memory */
+            error = verify_batch_each(items,n);
+        }
+    }
+
+    /* This function is non-secret, but whatever this is cheap.
+     * Only the first 2n+1 entries of the scratch space were touched.
+     */
+    hash_destroy(hash);
+    goldilocks_bzero(points,(2*n+1)*sizeof(points[0]));
+    goldilocks_bzero(scalars,(2*n+1)*sizeof(scalars[0]));
+    API_NS(point_destroy)(combo);
+    API_NS(scalar_destroy)(coefficient);
+    return error;
+}
+
+/* Find the bad signatures among items[0..n) by bisection. */
+static goldilocks_error_t verify_batch_bisect (
+    struct verify_batch_scratch *scratch,
+    goldilocks_error_t *results,
+    const goldilocks_ed448_verify_item_s *items,
+    size_t n
+) {
+    goldilocks_error_t ret = GOLDILOCKS_SUCCESS;
+    size_t i, half = n/2;
+
+    if (n == 1) {
+        results[0] = verify_batch_item(items);
+        return results[0];
+    }
+
+    if (GOLDILOCKS_SUCCESS == verify_batch_combined(scratch,items,n)) {
+        for (i=0; i<n; i++) results[i] = GOLDILOCKS_SUCCESS;
+        return GOLDILOCKS_SUCCESS;
+    }
+
+    if (GOLDILOCKS_SUCCESS != verify_batch_bisect(scratch,results,items,half)) {
+        ret = GOLDILOCKS_FAILURE;
+    }
+    if (GOLDILOCKS_SUCCESS != verify_batch_bisect(scratch,results+half,items+half,n-half)) {
+        ret = GOLDILOCKS_FAILURE;
+    }
+    return ret;
+}
+
+goldilocks_error_t goldilocks_ed448_verify_batch (
+    goldilocks_error_t *results,
+    const goldilocks_ed448_verify_item_s *items,
+    size_t n
+) {
+    goldilocks_error_t ret = GOLDILOCKS_SUCCESS;
+    struct verify_batch_scratch *scratch = NULL;
+    size_t start, m;
+
+    /* If this fails, just check the signatures one at a time */
+    if (n > 1) scratch = (struct verify_batch_scratch *)malloc_vector(sizeof(*scratch));
+
+    for (start=0; start<n; start+=m) {
+        m = n-start;
+        if (m > VERIFY_BATCH_MAX) m = VERIFY_BATCH_MAX;
+
+        if (results) {
+            if (GOLDILOCKS_SUCCESS != verify_batch_bisect(scratch,results+start,items+start,m)) {
+                ret = GOLDILOCKS_FAILURE;
+            }
+        } else if (GOLDILOCKS_SUCCESS != verify_batch_combined(scratch,items+start,m)) {
+            ret = GOLDILOCKS_FAILURE;
+            break;
+        }
+    }
+
+    free(scratch);
+    return ret;
+}
@@ -10,6 +10,8 @@
  */
 
 #include "field.h"
+#include "field4.h"
+#include "field8.h"
 
 mask_t gf_isr (
     gf a,
@@ -45,3 +47,142 @@ mask_t gf_isr (
     gf_copy(a,L1);
     return gf_eq(L0,ONE);
 }
+
+/* The gf_isr addition chain, for the multi-lane field types */
+#define ISR_CHAIN(T, sqrn, mul) do {            \
+    T L0, L1, L2;                               \
+    sqrn  (L1,     x,     1 );                  \
+    mul   (L2,     x,   L1 );                   \
+    sqrn  (L1,   L2,      1 );                  \
+    mul   (L2,     x,   L1 );                   \
+    sqrn  (L1,   L2,     3 );                   \
+    mul   (L0,   L2,   L1 );                    \
+    sqrn  (L1,   L0,     3 );                   \
+    mul   (L0,   L2,   L1 );                    \
+    sqrn  (L2,   L0,     9 );                   \
+    mul   (L1,   L0,   L2 );                    \
+    sqrn  (L0,   L1,      1 );                  \
+    mul   (L2,     x,   L0 );                   \
+    sqrn  (L0,   L2,    18 );                   \
+    mul   (L2,   L1,   L0 );                    \
+    sqrn  (L0,   L2,    37 );                   \
+    mul   (L1,   L2,   L0 );                    \
+    sqrn  (L0,   L1,    37 );                   \
+    mul   (L1,   L2,   L0 );                    \
+    sqrn  (L0,   L1,   111 );                   \
+    mul   (L2,   L1,   L0 );                    \
+    sqrn  (L0,   L2,      1 );                  \
+    mul   (L1,     x,   L0 );                   \
+    sqrn  (L0,   L1,   223 );                   \
+    mul   (a,    L2,   L0 );                    \
+} while(0)
+
+#if GF8_VECTORIZED
+static void gf8_sqrn (gf8_s *__restrict__ y, const gf8 x, int n) {
+    gf8 tmp;
+    if (n&1) {
+        gf8_sqr(y,x);
+        n--;
+    } else {
+        gf8_sqr(tmp,x);
+        gf8_sqr(y,tmp);
+        n-=2;
+    }
+    for (; n; n-=2) {
+        gf8_sqr(tmp,y);
+        gf8_sqr(y,tmp);
+    }
+}
+
+static void gf8_isr (gf8_s *__restrict__ a, const gf8 x) {
+    ISR_CHAIN(gf8, gf8_sqrn, gf8_mul);
+}
+#endif
+
+#if GF4_VECTORIZED
+static void gf4_sqrn (gf4_s *__restrict__ y, const gf4 x, int n) {
+    gf4 tmp;
+    if (n&1) {
+        gf4_sqr(y,x);
+        n--;
+    } else {
+        gf4_sqr(tmp,x);
+        gf4_sqr(y,tmp);
+        n-=2;
+    }
+    for (; n; n-=2) {
+        gf4_sqr(tmp,y);
+        gf4_sqr(y,tmp);
+    }
+}
+
+static void gf4_isr (gf4_s *__restrict__ a, const gf4 x) {
+    ISR_CHAIN(gf4, gf4_sqrn, gf4_mul);
+}
+#endif
+
+void gf_isr_batch (
+    gf_s *__restrict__ a,
+    mask_t *ok,
+    const gf_s *x,
+    unsigned int n
+) {
+    unsigned int i = 0, j;
+    gf t, u;
+
+    /* A lane is padded with 1 when fewer than the vector width are left;
+     * a whole vector run is still much cheaper than two gf_isr */
+#if GF8_VECTORIZED
+    if (gf8_supported()) {
+        gf8 x8, a8;
+        gf_s in[8], out[8];
+        unsigned int m;
+        for (i=0; n-i >= 2; i+=m) {
+            m = (n-i < 8) ? n-i : 8;
+            for (j=0; j<8; j++) gf_copy(&in[j], (j<m) ? &x[i+j] : ONE);
+            gf8_load(x8, in);
+            gf8_isr(a8, x8);
+            gf8_store(out, a8);
+            for (j=0; j<m; j++) gf_copy(&a[i+j], &out[j]);
+        }
+        goldilocks_bzero(x8,sizeof(x8));
+        goldilocks_bzero(a8,sizeof(a8));
+        goldilocks_bzero(in,sizeof(in));
+        goldilocks_bzero(out,sizeof(out));
+    } else
+#endif
+#if GF4_VECTORIZED
+    if (gf4_supported()) {
+        gf4 x4, a4;
+        gf in[4], out[4];
+        unsigned int m;
+        for (i=0; n-i >= 2; i+=m) {
+            m = (n-i < 4) ? n-i : 4;
+            for (j=0; j<4; j++) gf_copy(in[j], (j<m) ? &x[i+j] : ONE);
+            gf4_load(x4, in[0], in[1], in[2], in[3]);
+            gf4_isr(a4, x4);
+            gf4_store(out[0], out[1], out[2], out[3], a4);
+            for (j=0; j<m; j++) gf_copy(&a[i+j], out[j]);
+        }
+        goldilocks_bzero(x4,sizeof(x4));
+        goldilocks_bzero(a4,sizeof(a4));
+        goldilocks_bzero(in,sizeof(in));
+        goldilocks_bzero(out,sizeof(out));
+    } else
+#endif
+    { /* scalar only */ }
+
+    for (; i<n; i++) {
+        gf_isr(&a[i], &x[i]);
+    }
+
+    /* Same check as gf_isr: a^2 x = 1 */
+    for (j=0; j<n; j++) {
+        gf_sqr(t, &a[j]);
+        gf_mul(u, t, &x[j]);
+        ok[j] = gf_eq(u, ONE);
+    }
+
+    goldilocks_bzero(t,sizeof(t));
+    goldilocks_bzero(u,sizeof(u));
+}
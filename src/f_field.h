@@ -20,7 +20,11 @@
 #include "word.h"
 
 #define __GOLDILOCKS_448_GF_DEFINED__ 1
+#ifdef ARCH_GF_NLIMBS
+#define NLIMBS ARCH_GF_NLIMBS
+#else
 #define NLIMBS (64/sizeof(word_t))
+#endif
 #define SER_BYTES 56
 typedef struct gf_448_s {
     word_t limb[NLIMBS];
@@ -47,6 +51,7 @@ typedef struct gf_448_s {
 #define gf_sqr            gf_448_sqr
 #define gf_mulw_unsigned  gf_448_mulw_unsigned
 #define gf_isr            gf_448_isr
+#define gf_isr_batch      gf_448_isr_batch
 #define gf_serialize      gf_448_serialize
 #define gf_deserialize    gf_448_deserialize
 
@@ -77,6 +82,7 @@ void gf_mul (gf_s *__restrict__ out, const gf a, const gf b);
 void gf_mulw_unsigned (gf_s *__restrict__ out, const gf a, uint32_t b);
 void gf_sqr (gf_s *__restrict__ out, const gf a);
 mask_t gf_isr(gf a, const gf x); /** a^2 x = 1, QNR, or 0 if x=0.  Return true if successful */
+void gf_isr_batch(gf_s *__restrict__ a, mask_t *ok, const gf_s *x, unsigned int n); /** gf_isr of n elements, several at a time where the CPU allows */
 mask_t gf_eq (const gf x, const gf y);
 mask_t gf_lobit (const gf x);
 
@@ -95,7 +101,9 @@ mask_t gf_deserialize (gf x, const uint8_t serial[SER_BYTES],uint8_t hi_nmask);
 #ifndef LIMBPERM
   #define LIMBPERM(i) (i)
 #endif
-#define LIMB_MASK(i) (((1ull)<<LIMB_PLACE_VALUE(i))-1)
+#ifndef LIMB_MASK
+  #define LIMB_MASK(i) (((1ull)<<LIMB_PLACE_VALUE(i))-1)
+#endif
 
 static const gf ZERO = {{{0}}}, ONE = {{{ [LIMBPERM(0)] = 1 }}};
 
@@ -12,30 +12,41 @@
 #define _XOPEN_SOURCE 600 /* for posix_memalign */
 #include "word.h"
 #include "field.h"
+#include "field4.h"
+#include "field8.h"
 
 #include <goldilocks.h>
 #include <goldilocks/ed448.h>
 #include "api.h"
+#if GOLDILOCKS_SAFEGCD
+#include "safegcd.h"
+#endif
 
 /* Template stuff */
 #define point_p API_NS(point_p)
 #define precomputed_s API_NS(precomputed_s)
 
 /* Comb config: number of combs, n, t, s. */
+/* Comb geometry of the base point table; configure --with-comb-table sets these */
+#ifndef COMBS_N
 #define COMBS_N 5
 #define COMBS_T 5
 #define COMBS_S 18
+#endif
 #define GOLDILOCKS_WINDOW_BITS 5
 #define GOLDILOCKS_WNAF_FIXED_TABLE_BITS 5
 #define GOLDILOCKS_WNAF_VAR_TABLE_BITS 3
+#define GOLDILOCKS_WNAF_PREPARED_TABLE_BITS GOLDILOCKS_448_WNAF_TABLE_BITS
+#define GOLDILOCKS_BATCH_CHUNK 64 /* points per shared inversion in the batch encoders */
 
 static const int EDWARDS_D = -39081;
 static const scalar_p point_scalarmul_adjustment = {{{
     SC_LIMB(0xc873d6d54a7bb0cf), SC_LIMB(0xe933d8d723a70aad), SC_LIMB(0xbb124b65129c96fd), SC_LIMB(0x00000008335dc163)
-}}}, precomputed_scalarmul_adjustment = {{{
-    SC_LIMB(0xc873d6d54a7bb0cf), SC_LIMB(0xe933d8d723a70aad), SC_LIMB(0xbb124b65129c96fd), SC_LIMB(0x00000008335dc163)
 }}};
 
+/* 2^(COMBS_N*COMBS_T*COMBS_S) - 1, from goldilocks_gen_tables */
+extern const scalar_p API_NS(precomputed_scalarmul_adjustment);
+
 const uint8_t goldilocks_x448_base_point[GOLDILOCKS_X448_PUBLIC_BYTES] = { 0x05 };
 
 const gf GOLDILOCKS_448_FACTOR = {FIELD_LITERAL(
@@ -58,13 +69,45 @@ typedef struct { niels_p n; gf z; } VECTOR_ALIGNED pniels_s, pniels_p[1];
 /* Precomputed base */
 struct precomputed_s { niels_p table [COMBS_N<<(COMBS_T-1)]; };
 
+/* Precomputed comb table of any geometry */
+struct API_NS(precomputed_comb_s) {
+    unsigned int n, t, s;
+    scalar_p adjustment;
+    niels_p table[];
+};
+
+/* Largest comb table that API_NS(precompute_comb) will build, in entries */
+#define COMBS_MAX_ENTRIES 512
+
 extern const gf API_NS(precomputed_base_as_fe)[];
 const precomputed_s *API_NS(precomputed_base) =
     (const precomputed_s *) &API_NS(precomputed_base_as_fe);
 
 const size_t API_NS(sizeof_precomputed_s) = sizeof(precomputed_s);
 const size_t API_NS(alignof_precomputed_s) = sizeof(big_register_t);
+const unsigned int API_NS(precomputed_comb_bits) = COMBS_N*COMBS_T*COMBS_S;
+
+#if GOLDILOCKS_SAFEGCD
+/* p = 2^448 - 2^224 - 1 */
+static const uint8_t FIELD_MODULUS_BYTES[SER_BYTES] = {
+    0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+    0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+    0xfe,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+    0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
+};
 
+/** Inverse, by divsteps. */
+static void
+gf_invert(gf y, const gf x, int assert_nonzero) {
+    uint8_t buf[SER_BYTES];
+    gf_serialize(buf, x);
+    goldilocks_safegcd_invert(buf, buf, FIELD_MODULUS_BYTES);
+    ignore_result(gf_deserialize(y, buf, 0));
+    (void)assert_nonzero;
+    assert(!assert_nonzero || !gf_eq(y, ZERO));
+    goldilocks_bzero(buf, sizeof(buf));
+}
+#else
 /** Inverse. */
 static void
 gf_invert(gf y, const gf x, int assert_nonzero) {
@@ -78,6 +121,7 @@ gf_invert(gf y, const gf x, int assert_nonzero) {
     gf_mul(t2, t1, x); // not direct to y in case of alias.
     gf_copy(y, t2);
 }
+#endif
 
 /** identity = (0,1) */
 const point_p API_NS(point_identity) = {{{{{0}}},{{{1}}},{{{1}}},{{{0}}}}};
@@ -93,31 +137,36 @@ void API_NS(deisogenize) (
     mask_t toggle_rotation
 );
 
-// TODO: this function signature should change to not include
-// toggle_rotation
-void API_NS(deisogenize) (
+/* The radicand -x^2 * (a-d) * num whose isr deisogenize needs */
+static void deisogenize_radicand (
+    gf_s *__restrict__ radicand,
+    gf_s *__restrict__ num,
+    const point_p p
+) {
+    gf t1, t2;
+    gf_add(t1,p->x,p->t);
+    gf_sub(t2,p->x,p->t);
+    gf_mul(num,t1,t2);
+    gf_sqr(t2,p->x);
+    gf_mul(t1,t2,num);
+    gf_mulw(radicand,t1,-1-TWISTED_D);
+}
+
+static void deisogenize_finish (
     gf_s *__restrict__ s,
     gf_s *__restrict__ inv_el_sum,
     gf_s *__restrict__ inv_el_m1,
     const point_p p,
+    const gf num,
+    const gf isr,
     mask_t toggle_s,
-    mask_t toggle_altx,
-    mask_t toggle_rotation
+    mask_t toggle_altx
 ) {
-    gf t1;
     mask_t negx;
     mask_t lobs;
     gf_s *t2 = s, *t3=inv_el_sum, *t4=inv_el_m1;
-    (void)toggle_rotation; /* Only applies to cofactor 8 */
 
-    gf_add(t1,p->x,p->t);
-    gf_sub(t2,p->x,p->t);
-    gf_mul(t3,t1,t2); /* t3 = num */
-    gf_sqr(t2,p->x);
-    gf_mul(t1,t2,t3);
-    gf_mulw(t2,t1,-1-TWISTED_D); /* -x^2 * (a-d) * num */
-    gf_isr(t1,t2);    /* t1 = isr */
-    gf_mul(t2,t1,t3); /* t2 = ratio */
+    gf_mul(t2,isr,num); /* t2 = ratio */
     gf_mul(t4,t2,GOLDILOCKS_448_FACTOR);
     negx = gf_lobit(t4) ^ toggle_altx;
     gf_cond_neg(t2, negx);
@@ -125,7 +174,7 @@ void API_NS(deisogenize) (
     gf_sub(t3,t3,p->t);
     gf_mul(t2,t3,p->x);
     gf_mulw(t4,t2,-1-TWISTED_D);
-    gf_mul(s,t4,t1);
+    gf_mul(s,t4,isr);
     lobs = gf_lobit(s);
     gf_cond_neg(s,lobs);
     gf_copy(inv_el_m1,p->x);
@@ -133,19 +182,65 @@ void API_NS(deisogenize) (
     gf_add(inv_el_m1,inv_el_m1,p->t);
 }
 
+// TODO: this function signature should change to not include
+// toggle_rotation
+void API_NS(deisogenize) (
+    gf_s *__restrict__ s,
+    gf_s *__restrict__ inv_el_sum,
+    gf_s *__restrict__ inv_el_m1,
+    const point_p p,
+    mask_t toggle_s,
+    mask_t toggle_altx,
+    mask_t toggle_rotation
+) {
+    gf num, radicand, isr;
+    (void)toggle_rotation; /* Only applies to cofactor 8 */
+
+    deisogenize_radicand(radicand,num,p);
+    gf_isr(isr,radicand);
+    deisogenize_finish(s,inv_el_sum,inv_el_m1,p,num,isr,toggle_s,toggle_altx);
+}
+
 void API_NS(point_encode)( unsigned char ser[SER_BYTES], const point_p p ) {
     gf s,ie1,ie2;
     API_NS(deisogenize)(s,ie1,ie2,p,0,0,0);
     gf_serialize(ser,s);
 }
 
-goldilocks_error_t API_NS(point_decode) (
+void API_NS(point_encode_batch) (
+    unsigned char *ser,
+    const point_p *points,
+    size_t n
+) {
+    gf num[GOLDILOCKS_BATCH_CHUNK], radicand[GOLDILOCKS_BATCH_CHUNK], isr[GOLDILOCKS_BATCH_CHUNK];
+    mask_t ok[GOLDILOCKS_BATCH_CHUNK];
+    gf s,ie1,ie2;
+    size_t i, j, m;
+
+    for (i=0; i<n; i+=m) {
+        m = (n-i < GOLDILOCKS_BATCH_CHUNK) ? n-i : GOLDILOCKS_BATCH_CHUNK;
+        for (j=0; j<m; j++) {
+            deisogenize_radicand(radicand[j],num[j],points[i+j]);
+        }
+        gf_isr_batch((gf_s *)isr,ok,(const gf_s *)radicand,m);
+        for (j=0; j<m; j++) {
+            deisogenize_finish(s,ie1,ie2,points[i+j],num[j],isr[j],0,0);
+            gf_serialize(&ser[(i+j)*SER_BYTES],s);
+        }
+    }
+}
+
+/* Parse s and compute the radicand num*den^2 for its isr; leaves ynum and den in p->z, p->t */
+static mask_t point_decode_radicand (
     point_p p,
+    gf_s *__restrict__ s,
+    gf_s *__restrict__ num,
+    gf_s *__restrict__ radicand,
     const unsigned char ser[SER_BYTES],
     goldilocks_bool_t allow_identity
 ) {
-    gf s, s2, num, tmp;
-    gf_s *tmp2=s2, *ynum=p->z, *isr=p->x, *den=p->t;
+    gf s2, tmp;
+    gf_s *ynum=p->z, *den=p->t;
 
     mask_t succ = gf_deserialize(s, ser, 0);
     succ &= bool_to_mask(allow_identity) | ~gf_eq(s, ZERO);
@@ -157,8 +252,19 @@ goldilocks_error_t API_NS(point_decode) (
     gf_mulw(num,s2,-4*TWISTED_D);
     gf_sqr(tmp,den);               /* tmp = den^2 */
     gf_add(num,tmp,num);           /* num = den^2 - 4*d*s^2 */
-    gf_mul(tmp2,num,tmp);          /* tmp2 = num*den^2 */
-    succ &= gf_isr(isr,tmp2);      /* isr = 1/sqrt(num*den^2) */
+    gf_mul(radicand,num,tmp);      /* radicand = num*den^2 */
+    return succ;
+}
+
+/* Finish decoding with p->x = isr = 1/sqrt(num*den^2) */
+static void point_decode_finish (
+    point_p p,
+    const gf s,
+    const gf num
+) {
+    gf tmp, tmp2;
+    gf_s *ynum=p->z, *isr=p->x, *den=p->t;
+
     gf_mul(tmp,isr,den);           /* isr*den */
     gf_mul(p->y,tmp,ynum);         /* isr*den*(1-as^2) */
     gf_mul(tmp2,tmp,s);            /* s*isr*den */
@@ -170,11 +276,56 @@ goldilocks_error_t API_NS(point_decode) (
     /* Fill in z and t */
     gf_copy(p->z,ONE);
     gf_mul(p->t,p->x,p->y);
+}
+
+goldilocks_error_t API_NS(point_decode) (
+    point_p p,
+    const unsigned char ser[SER_BYTES],
+    goldilocks_bool_t allow_identity
+) {
+    gf s, num, radicand;
+
+    mask_t succ = point_decode_radicand(p,s,num,radicand,ser,allow_identity);
+    succ &= gf_isr(p->x,radicand); /* isr = 1/sqrt(num*den^2) */
+    point_decode_finish(p,s,num);
 
     assert(API_NS(point_valid)(p) | ~succ);
     return goldilocks_succeed_if(mask_to_bool(succ));
 }
 
+goldilocks_error_t API_NS(point_decode_batch) (
+    point_p *points,
+    goldilocks_error_t *results,
+    const unsigned char *ser,
+    size_t n,
+    goldilocks_bool_t allow_identity
+) {
+    gf s[GOLDILOCKS_BATCH_CHUNK], num[GOLDILOCKS_BATCH_CHUNK];
+    gf radicand[GOLDILOCKS_BATCH_CHUNK], isr[GOLDILOCKS_BATCH_CHUNK];
+    mask_t succ[GOLDILOCKS_BATCH_CHUNK], ok[GOLDILOCKS_BATCH_CHUNK];
+    mask_t all = -1;
+    size_t i, j, m;
+
+    for (i=0; i<n; i+=m) {
+        m = (n-i < GOLDILOCKS_BATCH_CHUNK) ? n-i : GOLDILOCKS_BATCH_CHUNK;
+        for (j=0; j<m; j++) {
+            succ[j] = point_decode_radicand(points[i+j],s[j],num[j],radicand[j],
+                &ser[(i+j)*SER_BYTES],allow_identity);
+        }
+        gf_isr_batch((gf_s *)isr,ok,(const gf_s *)radicand,m);
+        for (j=0; j<m; j++) {
+            succ[j] &= ok[j];
+            gf_copy(points[i+j]->x,isr[j]);
+            point_decode_finish(points[i+j],s[j],num[j]);
+            assert(API_NS(point_valid)(points[i+j]) | ~succ[j]);
+            if (results) results[i+j] = goldilocks_succeed_if(mask_to_bool(succ[j]));
+            all &= succ[j];
+        }
+    }
+
+    return goldilocks_succeed_if(mask_to_bool(all));
+}
+
 void API_NS(point_sub) (
     point_p p,
     const point_p q,
@@ -725,6 +876,30 @@ static void gf_batch_invert (
     }
 }
 
+/* Batch inversion in which zero inputs give zero outputs, as gf_invert does */
+static void gf_batch_invert_ct (
+    gf *__restrict__ out,
+    gf *in,
+    unsigned int n
+) {
+    mask_t zero[GOLDILOCKS_BATCH_CHUNK];
+    unsigned int i;
+    assert(n>0 && n<=GOLDILOCKS_BATCH_CHUNK);
+
+    for (i=0; i<n; i++) {
+        zero[i] = gf_eq(in[i],ZERO);
+        gf_cond_sel(in[i],in[i],ONE,zero[i]);
+    }
+    if (n == 1) {
+        gf_invert(out[0],in[0],1);
+    } else {
+        gf_batch_invert(out,(const gf *)in,n);
+    }
+    for (i=0; i<n; i++) {
+        gf_cond_sel(out[i],out[i],ZERO,zero[i]);
+    }
+}
+
 static void batch_normalize_niels (
     niels_p *table,
     const gf *zs,
@@ -752,11 +927,13 @@ static void batch_normalize_niels (
     goldilocks_bzero(product,sizeof(product));
 }
 
-void API_NS(precompute) (
-    precomputed_s *table,
-    const point_p base
+static void precompute_comb (
+    niels_p *table,
+    const point_p base,
+    unsigned int n,
+    unsigned int t,
+    unsigned int s
 ) {
-    const unsigned int n = COMBS_N, t = COMBS_T, s = COMBS_S;
     point_p working, start, doubles[t-1];
     pniels_p pn_tmp;
     gf zs[n<<(t-1)], zis[n<<(t-1)];
@@ -790,7 +967,7 @@ void API_NS(precompute) (
             int delta;
 
             pt_to_pniels(pn_tmp, start);
-            memcpy(table->table[idx], pn_tmp->n, sizeof(pn_tmp->n));
+            memcpy(table[idx], pn_tmp->n, sizeof(pn_tmp->n));
             gf_copy(zs[idx], pn_tmp->z);
 
             if (j >= (1u<<(t-1)) - 1) break;
@@ -807,7 +984,7 @@ void API_NS(precompute) (
         }
     }
 
-    batch_normalize_niels(table->table,(const gf *)zs,zis,n<<(t-1));
+    batch_normalize_niels(table,(const gf *)zs,zis,n<<(t-1));
 
     goldilocks_bzero(zs,sizeof(zs));
     goldilocks_bzero(zis,sizeof(zis));
@@ -817,6 +994,66 @@ void API_NS(precompute) (
     goldilocks_bzero(doubles,sizeof(doubles));
 }
 
+void API_NS(precompute) (
+    precomputed_s *table,
+    const point_p base
+) {
+    precompute_comb(table->table, base, COMBS_N, COMBS_T, COMBS_S);
+}
+
+static goldilocks_bool_t comb_geometry_ok (
+    unsigned int n,
+    unsigned int t,
+    unsigned int s
+) {
+    /* Bound each factor before multiplying, so nothing can overflow */
+    return n >= 1 && n <= COMBS_MAX_ENTRIES/2
+        && t >= 2 && t <= 10
+        && s >= 1 && s <= SCALAR_BITS
+        && (n<<(t-1)) <= COMBS_MAX_ENTRIES
+        && n*t*s >= SCALAR_BITS;
+}
+
+size_t API_NS(sizeof_precomputed_comb) (
+    unsigned int n,
+    unsigned int t,
+    unsigned int s
+) {
+    if (!comb_geometry_ok(n,t,s)) return 0;
+    return sizeof(struct API_NS(precomputed_comb_s)) + (sizeof(niels_p) * n << (t-1));
+}
+
+goldilocks_error_t API_NS(precompute_comb) (
+    struct API_NS(precomputed_comb_s) *table,
+    const point_p base,
+    unsigned int n,
+    unsigned int t,
+    unsigned int s
+) {
+    unsigned int i;
+    if (!comb_geometry_ok(n,t,s)) return GOLDILOCKS_FAILURE;
+
+    table->n = n;
+    table->t = t;
+    table->s = s;
+
+    /* adjustment = 2^(n*t*s) - 1 */
+    API_NS(scalar_copy)(table->adjustment, API_NS(scalar_one));
+    for (i=0; i<n*t*s; i++) {
+        API_NS(scalar_add)(table->adjustment, table->adjustment, table->adjustment);
+    }
+    API_NS(scalar_sub)(table->adjustment, table->adjustment, API_NS(scalar_one));
+
+    precompute_comb(table->table, base, n, t, s);
+    return GOLDILOCKS_SUCCESS;
+}
+
+void API_NS(precomputed_comb_destroy) (
+    struct API_NS(precomputed_comb_s) *table
+) {
+    goldilocks_bzero(table, API_NS(sizeof_precomputed_comb)(table->n, table->t, table->s));
+}
+
 static GOLDILOCKS_INLINE void
 constant_time_lookup_niels (
     niels_s *__restrict__ ni,
@@ -827,19 +1064,22 @@ constant_time_lookup_niels (
     constant_time_lookup(ni, table, sizeof(niels_s), nelts, idx);
 }
 
-void API_NS(precomputed_scalarmul) (
+static void comb_scalarmul (
     point_p out,
-    const precomputed_s *table,
-    const scalar_p scalar
+    const niels_p *table,
+    const scalar_p adjustment,
+    const scalar_p scalar,
+    unsigned int n,
+    unsigned int t,
+    unsigned int s
 ) {
     int i;
     unsigned j,k;
-    const unsigned int n = COMBS_N, t = COMBS_T, s = COMBS_S;
 
     scalar_p scalar1x;
     niels_p ni;
 
-    API_NS(scalar_add)(scalar1x, scalar, precomputed_scalarmul_adjustment);
+    API_NS(scalar_add)(scalar1x, scalar, adjustment);
     API_NS(scalar_halve)(scalar1x,scalar1x);
 
 
@@ -861,7 +1101,7 @@ void API_NS(precomputed_scalarmul) (
             tab ^= invert;
             tab &= (1<<(t-1)) - 1;
 
-            constant_time_lookup_niels(ni, &table->table[j<<(t-1)], 1<<(t-1), tab);
+            constant_time_lookup_niels(ni, &table[j<<(t-1)], 1<<(t-1), tab);
 
             cond_neg_niels(ni, invert);
             if ((i!=(int)s-1)||j) {
@@ -876,6 +1116,23 @@ void API_NS(precomputed_scalarmul) (
     goldilocks_bzero(scalar1x,sizeof(scalar1x));
 }
 
+void API_NS(precomputed_scalarmul) (
+    point_p out,
+    const precomputed_s *table,
+    const scalar_p scalar
+) {
+    comb_scalarmul(out, table->table, API_NS(precomputed_scalarmul_adjustment), scalar,
+        COMBS_N, COMBS_T, COMBS_S);
+}
+
+void API_NS(precomputed_comb_scalarmul) (
+    point_p out,
+    const struct API_NS(precomputed_comb_s) *table,
+    const scalar_p scalar
+) {
+    comb_scalarmul(out, table->table, table->adjustment, scalar, table->n, table->t, table->s);
+}
+
 void API_NS(point_cond_sel) (
     point_p out,
     const point_p a,
@@ -946,6 +1203,61 @@ void API_NS(point_mul_by_ratio_and_encode_like_eddsa) (
 }
 
 
+void API_NS(point_mul_by_ratio_and_encode_like_eddsa_batch) (
+    uint8_t *enc,
+    const point_p *points,
+    size_t n
+) {
+    gf x[GOLDILOCKS_BATCH_CHUNK], y[GOLDILOCKS_BATCH_CHUNK];
+    gf z[GOLDILOCKS_BATCH_CHUNK], zi[GOLDILOCKS_BATCH_CHUNK];
+    gf t, u, v;
+    uint8_t *e;
+    size_t i, j, m;
+
+    for (i=0; i<n; i+=m) {
+        m = (n-i < GOLDILOCKS_BATCH_CHUNK) ? n-i : GOLDILOCKS_BATCH_CHUNK;
+        for (j=0; j<m; j++) {
+            const API_NS(point_s) *q = points[i+j];
+            /* Same 4-isogeny as point_mul_by_ratio_and_encode_like_eddsa */
+            gf_sqr ( x[j], q->x );
+            gf_sqr ( t, q->y );
+            gf_add ( u, x[j], t );
+            gf_add ( z[j], q->y, q->x );
+            gf_sqr ( y[j], z[j] );
+            gf_sub ( y[j], y[j], u );
+            gf_sub ( z[j], t, x[j] );
+            gf_sqr ( x[j], q->z );
+            gf_add ( t, x[j], x[j] );
+            gf_sub ( t, t, z[j] );
+            gf_mul ( x[j], t, y[j] );
+            gf_mul ( v, z[j], u );
+            gf_copy ( y[j], v );
+            gf_mul ( z[j], u, t );
+        }
+
+        /* Affinize all of them with one inversion */
+        gf_batch_invert_ct(zi,z,m);
+
+        for (j=0; j<m; j++) {
+            gf_mul(t,x[j],zi[j]);
+            gf_mul(u,y[j],zi[j]);
+            e = &enc[(i+j)*GOLDILOCKS_EDDSA_448_PUBLIC_BYTES];
+            e[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES-1] = 0;
+            gf_serialize(e, u);
+            e[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES-1] |= 0x80 & gf_lobit(t);
+        }
+    }
+
+    goldilocks_bzero(x,sizeof(x));
+    goldilocks_bzero(y,sizeof(y));
+    goldilocks_bzero(z,sizeof(z));
+    goldilocks_bzero(zi,sizeof(zi));
+    goldilocks_bzero(t,sizeof(t));
+    goldilocks_bzero(u,sizeof(u));
+    goldilocks_bzero(v,sizeof(v));
+}
+
+
 goldilocks_error_t API_NS(point_decode_like_eddsa_and_mul_by_ratio) (
     point_p p,
     const uint8_t enc[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES]
@@ -1003,15 +1315,16 @@ goldilocks_error_t API_NS(point_decode_like_eddsa_and_mul_by_ratio) (
     return goldilocks_succeed_if(mask_to_bool(succ));
 }
 
-goldilocks_error_t goldilocks_x448 (
-    uint8_t out[X_PUBLIC_BYTES],
-    const uint8_t base[X_PUBLIC_BYTES],
+/* The RFC 7748 ladder, leaving the result as x2/z2 */
+static void x448_ladder (
+    gf x2,
+    gf z2,
+    const gf x1,
     const uint8_t scalar[X_PRIVATE_BYTES]
 ) {
-    gf x1, x2, z2, x3, z3, t1, t2;
+    gf x3, z3, t1, t2;
     int t;
-    mask_t swap = 0, nz = 0;
-    ignore_result(gf_deserialize(x1,base,0));
+    mask_t swap = 0;
     gf_copy(x2,ONE);
     gf_copy(z2,ZERO);
     gf_copy(x3,x1);
@@ -1059,11 +1372,106 @@ goldilocks_error_t goldilocks_x448 (
     /* Finish */
     gf_cond_swap(x2,x3,swap);
     gf_cond_swap(z2,z3,swap);
+
+    goldilocks_bzero(x3,sizeof(x3));
+    goldilocks_bzero(z3,sizeof(z3));
+    goldilocks_bzero(t1,sizeof(t1));
+    goldilocks_bzero(t2,sizeof(t2));
+}
+
+goldilocks_error_t goldilocks_x448 (
+    uint8_t out[X_PUBLIC_BYTES],
+    const uint8_t base[X_PUBLIC_BYTES],
+    const uint8_t scalar[X_PRIVATE_BYTES]
+) {
+    gf x1, x2, z2;
+    mask_t nz;
+    ignore_result(gf_deserialize(x1,base,0));
+    x448_ladder(x2,z2,x1,scalar);
+
     gf_invert(z2,z2,0);
     gf_mul(x1,x2,z2);
     gf_serialize(out,x1);
     nz = ~gf_eq(x1,ZERO);
 
+    goldilocks_bzero(x1,sizeof(x1));
+    goldilocks_bzero(x2,sizeof(x2));
+    goldilocks_bzero(z2,sizeof(z2));
+
+    return goldilocks_succeed_if(mask_to_bool(nz));
+}
+
+/* The x448_ladder step on W lanes at once, each with its own base and scalar.
+ * The caller declares the T values x1, x2, z2, x3, z3, t1, t2 and loads
+ * x1 with the bases, x2 and z3 with 1 and x3 with x1, z2 with 0.
+ */
+#define X448_LADDER_LANES(W, cond_swap, add, sub, mul, sqr, mulw) do {  \
+    mask_t swap[W], k_t[W];                                             \
+    unsigned int j;                                                     \
+    int t;                                                              \
+    for (j=0; j<W; j++) swap[j] = 0;                                    \
+    for (t = X_PRIVATE_BITS-1; t>=0; t--) {                             \
+        for (j=0; j<W; j++) {                                           \
+            uint8_t sb = scalars[j*X_PRIVATE_BYTES + t/8];              \
+            if (t/8==0) sb &= -(uint8_t)COFACTOR;                       \
+            else if (t == X_PRIVATE_BITS-1) sb = -1;                    \
+            k_t[j] = -(mask_t)((sb>>(t%8)) & 1);                        \
+            swap[j] ^= k_t[j];                                          \
+        }                                                               \
+        cond_swap(x2,x3,swap);                                          \
+        cond_swap(z2,z3,swap);                                          \
+        for (j=0; j<W; j++) swap[j] = k_t[j];                           \
+                                                                        \
+        add(t1,x2,z2);                                                  \
+        sub(t2,x2,z2);                                                  \
+        sub(z2,x3,z3);                                                  \
+        mul(x2,t1,z2);                                                  \
+        add(z2,z3,x3);                                                  \
+        mul(x3,t2,z2);                                                  \
+        sub(z3,x2,x3);                                                  \
+        sqr(z2,z3);                                                     \
+        mul(z3,x1,z2);                                                  \
+        add(z2,x2,x3);                                                  \
+        sqr(x3,z2);                                                     \
+                                                                        \
+        sqr(z2,t1);                                                     \
+        sqr(t1,t2);                                                     \
+        mul(x2,z2,t1);                                                  \
+        sub(t2,z2,t1);                                                  \
+                                                                        \
+        mulw(t1,t2,-EDWARDS_D);                                         \
+        add(t1,t1,z2);                                                  \
+        mul(z2,t2,t1);                                                  \
+    }                                                                   \
+    cond_swap(x2,x3,swap);                                              \
+    cond_swap(z2,z3,swap);                                              \
+} while(0)
+
+#if GF8_VECTORIZED
+/* Eight ladders in the lanes of gf8s */
+static void x448_ladder8 (
+    gf_s x[8],
+    gf_s z[8],
+    const gf_s base[8],
+    const uint8_t scalars[8*X_PRIVATE_BYTES]
+) {
+    gf8 x1, x2, z2, x3, z3, t1, t2;
+    gf_s lanes[8];
+    unsigned int i;
+
+    gf8_load(x1,base);
+    for (i=0; i<8; i++) gf_copy(&lanes[i],ONE);
+    gf8_load(x2,lanes);
+    gf8_load(z3,lanes);
+    for (i=0; i<8; i++) gf_copy(&lanes[i],ZERO);
+    gf8_load(z2,lanes);
+    memcpy(x3,x1,sizeof(x3));
+
+    X448_LADDER_LANES(8, gf8_cond_swap, gf8_add, gf8_sub, gf8_mul, gf8_sqr, gf8_mulw_unsigned);
+
+    gf8_store(x,x2);
+    gf8_store(z,z2);
+
     goldilocks_bzero(x1,sizeof(x1));
     goldilocks_bzero(x2,sizeof(x2));
     goldilocks_bzero(z2,sizeof(z2));
@@ -1071,8 +1479,106 @@ goldilocks_error_t goldilocks_x448 (
     goldilocks_bzero(z3,sizeof(z3));
     goldilocks_bzero(t1,sizeof(t1));
     goldilocks_bzero(t2,sizeof(t2));
+}
+#endif
 
-    return goldilocks_succeed_if(mask_to_bool(nz));
+/* Four ladders in the lanes of gf4s: vectorized, or else interleaved */
+static void x448_ladder4 (
+    gf_s x[4],
+    gf_s z[4],
+    const gf_s base[4],
+    const uint8_t scalars[4*X_PRIVATE_BYTES]
+) {
+    gf4 x1, x2, z2, x3, z3, t1, t2;
+
+    gf4_load(x1,&base[0],&base[1],&base[2],&base[3]);
+    gf4_load(x2,ONE,ONE,ONE,ONE);
+    gf4_load(z2,ZERO,ZERO,ZERO,ZERO);
+    memcpy(x3,x1,sizeof(x3));
+    gf4_load(z3,ONE,ONE,ONE,ONE);
+
+    X448_LADDER_LANES(4, gf4_cond_swap, gf4_add, gf4_sub, gf4_mul, gf4_sqr, gf4_mulw_unsigned);
+
+    gf4_store(&x[0],&x[1],&x[2],&x[3],x2);
+    gf4_store(&z[0],&z[1],&z[2],&z[3],z2);
+
+    goldilocks_bzero(x1,sizeof(x1));
+    goldilocks_bzero(x2,sizeof(x2));
+    goldilocks_bzero(z2,sizeof(z2));
+    goldilocks_bzero(x3,sizeof(x3));
+    goldilocks_bzero(z3,sizeof(z3));
+    goldilocks_bzero(t1,sizeof(t1));
+    goldilocks_bzero(t2,sizeof(t2));
+}
+
+goldilocks_error_t goldilocks_x448_batch (
+    uint8_t *out,
+    goldilocks_error_t *results,
+    const uint8_t *base,
+    const uint8_t *scalar,
+    size_t n
+) {
+    gf x[GOLDILOCKS_BATCH_CHUNK], z[GOLDILOCKS_BATCH_CHUNK], zi[GOLDILOCKS_BATCH_CHUNK];
+    gf_s x1[8], lx[8], lz[8];
+    uint8_t scalars[8*X_PRIVATE_BYTES];
+    unsigned int lanes = 1, step, j, k;
+    size_t i, m;
+    mask_t nz, all = -1;
+
+#if GF8_VECTORIZED
+    if (gf8_supported()) lanes = 8;
+    else
+#endif
+    if (!GF4_VECTORIZED || gf4_supported()) lanes = 4;
+
+    for (i=0; i<n; i+=m) {
+        m = (n-i < GOLDILOCKS_BATCH_CHUNK) ? n-i : GOLDILOCKS_BATCH_CHUNK;
+
+        /* Run the ladders a vector at a time, padding the last vector
+         * with copies of its first lane.  A lone ladder is run by itself.
+         */
+        for (j=0; j<m; j+=step) {
+            step = lanes;
+            if (lanes == 1 || m-j == 1) {
+                ignore_result(gf_deserialize(&x1[0],&base[(i+j)*X_PUBLIC_BYTES],0));
+                x448_ladder(x[j],z[j],&x1[0],&scalar[(i+j)*X_PRIVATE_BYTES]);
+                step = 1;
+                continue;
+            }
+            for (k=0; k<lanes; k++) {
+                size_t src = i+j + ((j+k<m) ? k : 0);
+                ignore_result(gf_deserialize(&x1[k],&base[src*X_PUBLIC_BYTES],0));
+                memcpy(&scalars[k*X_PRIVATE_BYTES],&scalar[src*X_PRIVATE_BYTES],X_PRIVATE_BYTES);
+            }
+#if GF8_VECTORIZED
+            if (lanes == 8) x448_ladder8(lx,lz,x1,scalars);
+            else
+#endif
+            x448_ladder4(lx,lz,x1,scalars);
+            for (k=0; k<lanes && j+k<m; k++) {
+                gf_copy(x[j+k],&lx[k]);
+                gf_copy(z[j+k],&lz[k]);
+            }
+        }
+
+        gf_batch_invert_ct(zi,z,m);
+        for (j=0; j<m; j++) {
+            gf_mul(&x1[0],x[j],zi[j]);
+            gf_serialize(&out[(i+j)*X_PUBLIC_BYTES],&x1[0]);
+            nz = ~gf_eq(&x1[0],ZERO);
+            if (results) results[i+j] = goldilocks_succeed_if(mask_to_bool(nz));
+            all &= nz;
+        }
+    }
+
+    goldilocks_bzero(x,sizeof(x));
+    goldilocks_bzero(z,sizeof(z));
+    goldilocks_bzero(zi,sizeof(zi));
+    goldilocks_bzero(x1,sizeof(x1));
+    goldilocks_bzero(lx,sizeof(lx));
+    goldilocks_bzero(lz,sizeof(lz));
+    goldilocks_bzero(scalars,sizeof(scalars));
+    return goldilocks_succeed_if(mask_to_bool(all));
 }
 
 /* Thanks Johan Pascal */
@@ -1114,6 +1620,34 @@ void API_NS(point_mul_by_ratio_and_encode_like_x448) (
     API_NS(point_destroy(q));
 }
 
+void API_NS(point_mul_by_ratio_and_encode_like_x448_batch) (
+    uint8_t *out,
+    const point_p *points,
+    size_t n
+) {
+    gf x[GOLDILOCKS_BATCH_CHUNK], xi[GOLDILOCKS_BATCH_CHUNK];
+    gf t, u;
+    size_t i, j, m;
+
+    for (i=0; i<n; i+=m) {
+        m = (n-i < GOLDILOCKS_BATCH_CHUNK) ? n-i : GOLDILOCKS_BATCH_CHUNK;
+        for (j=0; j<m; j++) {
+            gf_copy(x[j],points[i+j]->x);
+        }
+        gf_batch_invert_ct(xi,x,m); /* 1/x */
+        for (j=0; j<m; j++) {
+            gf_mul(t,xi[j],points[i+j]->y); /* y/x */
+            gf_sqr(u,t); /* (y/x)^2 */
+            gf_serialize(&out[(i+j)*X_PUBLIC_BYTES],u);
+        }
+    }
+
+    goldilocks_bzero(x,sizeof(x));
+    goldilocks_bzero(xi,sizeof(xi));
+    goldilocks_bzero(t,sizeof(t));
+    goldilocks_bzero(u,sizeof(u));
+}
+
 void goldilocks_x448_derive_public_key (
     uint8_t out[X_PUBLIC_BYTES],
     const uint8_t scalar[X_PRIVATE_BYTES]
@@ -1140,6 +1674,156 @@ void goldilocks_x448_derive_public_key (
     API_NS(point_destroy)(p);
 }
 
+void goldilocks_x448_derive_public_key_batch (
+    uint8_t *out,
+    const uint8_t *scalar,
+    size_t n
+) {
+    uint8_t scalar2[X_PRIVATE_BYTES];
+    scalar_p the_scalar;
+    point_p p[GOLDILOCKS_BATCH_CHUNK];
+    unsigned int c;
+    size_t i, j, m;
+
+    for (i=0; i<n; i+=m) {
+        m = (n-i < GOLDILOCKS_BATCH_CHUNK) ? n-i : GOLDILOCKS_BATCH_CHUNK;
+        for (j=0; j<m; j++) {
+            /* Scalar conditioning, as in goldilocks_x448_derive_public_key */
+            memcpy(scalar2,&scalar[(i+j)*X_PRIVATE_BYTES],sizeof(scalar2));
+            scalar2[0] &= -(uint8_t)COFACTOR;
+
+            scalar2[X_PRIVATE_BYTES-1] &= ~(-1u<<((X_PRIVATE_BITS+7)%8));
+            scalar2[X_PRIVATE_BYTES-1] |= 1<<((X_PRIVATE_BITS+7)%8);
+
+            API_NS(scalar_decode_long)(the_scalar,scalar2,sizeof(scalar2));
+            for (c=1; c<GOLDILOCKS_X448_ENCODE_RATIO; c<<=1) {
+                API_NS(scalar_halve)(the_scalar,the_scalar);
+            }
+            API_NS(precomputed_scalarmul)(p[j],API_NS(precomputed_base),the_scalar);
+        }
+        API_NS(point_mul_by_ratio_and_encode_like_x448_batch)(&out[i*X_PUBLIC_BYTES],(const point_p *)p,m);
+    }
+
+    goldilocks_bzero(scalar2,sizeof(scalar2));
+    API_NS(scalar_destroy)(the_scalar);
+    goldilocks_bzero(p,sizeof(p));
+}
+
+/* Prepared X448 peer: a table for four times an Edwards preimage of its u-coordinate */
+struct goldilocks_x448_prepared_peer_s {
+    precomputed_s table;
+    uint8_t peer[X_PUBLIC_BYTES];
+    mask_t on_curve;
+};
+
+const size_t goldilocks_x448_sizeof_prepared_peer = sizeof(goldilocks_x448_prepared_peer_s);
+const size_t goldilocks_x448_alignof_prepared_peer = sizeof(big_register_t);
+
+void goldilocks_x448_prepare_peer (
+    goldilocks_x448_prepared_peer_s *prepared,
+    const uint8_t peer[X_PUBLIC_BYTES]
+) {
+    gf u, a, b, c, x2;
+    point_p p;
+    mask_t succ, ok;
+
+    memcpy(prepared->peer,peer,X_PUBLIC_BYTES);
+    ignore_result(gf_deserialize(u,peer,0));
+
+    /* Find p on the internal curve with (y/x)^2 = u.  With X = x^2 and y^2 = uX,
+     * the curve equation becomes d u X^2 - (u-1) X + 1 = 0.
+     */
+    gf_sub(a,u,ONE);                    /* u-1 */
+    gf_sqr(b,a);
+    gf_mulw(c,u,-4*TWISTED_D);
+    gf_add(b,b,c);                      /* (u-1)^2 - 4du */
+    succ = gf_isr(c,b);
+    gf_mul(x2,b,c);                     /* sqrt((u-1)^2 - 4du) */
+
+    gf_mulw(c,u,2*TWISTED_D);
+    succ &= ~gf_eq(c,ZERO);
+    gf_invert(c,c,0);                   /* 1/2du */
+    gf_add(b,a,x2);
+    gf_sub(a,a,x2);
+    gf_mul(x2,b,c);
+    gf_mul(b,a,c);                      /* the two roots X */
+
+    ok = gf_isr(a,x2);
+    gf_cond_sel(x2,b,x2,ok);            /* Of the roots, one is square if any is */
+    succ &= gf_isr(a,x2);
+    gf_mul(p->x,x2,a);                  /* x = sqrt(X) */
+
+    succ &= gf_isr(a,u);
+    gf_mul(b,a,u);                      /* sqrt(u) */
+    gf_mul(p->y,p->x,b);
+    gf_copy(p->z,ONE);
+    gf_mul(p->t,p->x,p->y);
+
+    /* Clear the cofactor; shared secrets compensate for it in the scalar */
+    API_NS(point_double)(p,p);
+    API_NS(point_double)(p,p);
+    succ &= bool_to_mask(API_NS(point_valid)(p));
+
+    /* The peer's key is public, so it's fine to branch on it */
+    prepared->on_curve = succ;
+    if (succ) {
+        API_NS(precompute)(&prepared->table,p);
+    } else {
+        goldilocks_bzero(&prepared->table,sizeof(prepared->table));
+    }
+
+    goldilocks_bzero(u,sizeof(u));
+    goldilocks_bzero(a,sizeof(a));
+    goldilocks_bzero(b,sizeof(b));
+    goldilocks_bzero(c,sizeof(c));
+    goldilocks_bzero(x2,sizeof(x2));
+    API_NS(point_destroy)(p);
+}
+
+goldilocks_error_t goldilocks_x448_shared_secret_prepared (
+    uint8_t out[X_PUBLIC_BYTES],
+    const goldilocks_x448_prepared_peer_s *prepared,
+    const uint8_t scalar[X_PRIVATE_BYTES]
+) {
+    /* Scalar conditioning */
+    uint8_t scalar2[X_PRIVATE_BYTES];
+    scalar_p the_scalar;
+    point_p p;
+    gf u;
+    mask_t nz;
+
+    /* Points off the curve, ie on its twist, have no table */
+    if (!prepared->on_curve) return goldilocks_x448(out,prepared->peer,scalar);
+
+    memcpy(scalar2,scalar,sizeof(scalar2));
+    scalar2[0] &= -(uint8_t)COFACTOR;
+
+    scalar2[X_PRIVATE_BYTES-1] &= ~(-1u<<((X_PRIVATE_BITS+7)%8));
+    scalar2[X_PRIVATE_BYTES-1] |= 1<<((X_PRIVATE_BITS+7)%8);
+
+    API_NS(scalar_decode_long)(the_scalar,scalar2,sizeof(scalar2));
+
+    /* Compensate for the table being for four times the peer's point */
+    API_NS(scalar_halve)(the_scalar,the_scalar);
+    API_NS(scalar_halve)(the_scalar,the_scalar);
+    API_NS(precomputed_scalarmul)(p,&prepared->table,the_scalar);
+    API_NS(point_mul_by_ratio_and_encode_like_x448)(out,p);
+    ignore_result(gf_deserialize(u,out,0));
+    nz = ~gf_eq(u,ZERO);
+
+    goldilocks_bzero(scalar2,sizeof(scalar2));
+    goldilocks_bzero(u,sizeof(u));
+    API_NS(scalar_destroy)(the_scalar);
+    API_NS(point_destroy)(p);
+    return goldilocks_succeed_if(mask_to_bool(nz));
+}
+
+void goldilocks_x448_prepared_peer_destroy (
+    goldilocks_x448_prepared_peer_s *prepared
+) {
+    goldilocks_bzero(prepared, sizeof(*prepared));
+}
+
 /**
  * @cond internal
  * Control for variable-time scalar multiply algorithms.
@@ -1238,25 +1922,41 @@ void API_NS(precompute_wnafs) (
     const point_p base
 ) __attribute__ ((visibility ("hidden")));
 
-void API_NS(precompute_wnafs) (
-    niels_p out[1<<GOLDILOCKS_WNAF_FIXED_TABLE_BITS],
-    const point_p base
+/* Odd multiples of base, in affine Niels form */
+static void prepare_wnaf_table_niels (
+    niels_p *out,
+    const point_p base,
+    unsigned int tbits
 ) {
-    pniels_p tmp[1<<GOLDILOCKS_WNAF_FIXED_TABLE_BITS];
-    gf zs[1<<GOLDILOCKS_WNAF_FIXED_TABLE_BITS], zis[1<<GOLDILOCKS_WNAF_FIXED_TABLE_BITS];
+    pniels_p tmp[1<<tbits];
+    gf zs[1<<tbits], zis[1<<tbits];
     int i;
-    prepare_wnaf_table(tmp,base,GOLDILOCKS_WNAF_FIXED_TABLE_BITS);
-    for (i=0; i<1<<GOLDILOCKS_WNAF_FIXED_TABLE_BITS; i++) {
+    prepare_wnaf_table(tmp,base,tbits);
+    for (i=0; i<1<<tbits; i++) {
         memcpy(out[i], tmp[i]->n, sizeof(niels_p));
         gf_copy(zs[i], tmp[i]->z);
     }
-    batch_normalize_niels(out, (const gf *)zs, zis, 1<<GOLDILOCKS_WNAF_FIXED_TABLE_BITS);
+    batch_normalize_niels(out, (const gf *)zs, zis, 1<<tbits);
 
     goldilocks_bzero(tmp,sizeof(tmp));
     goldilocks_bzero(zs,sizeof(zs));
     goldilocks_bzero(zis,sizeof(zis));
 }
 
+void API_NS(precompute_wnafs) (
+    niels_p out[1<<GOLDILOCKS_WNAF_FIXED_TABLE_BITS],
+    const point_p base
+) {
+    prepare_wnaf_table_niels(out, base, GOLDILOCKS_WNAF_FIXED_TABLE_BITS);
+}
+
+void API_NS(precompute_wnaf) (
+    API_NS(precomputed_wnaf_p) table,
+    const point_p base
+) {
+    prepare_wnaf_table_niels((niels_p *)table->table, base, GOLDILOCKS_WNAF_PREPARED_TABLE_BITS);
+}
+
 void API_NS(base_double_scalarmul_non_secret) (
     point_p combo,
     const scalar_p scalar1,
@@ -1329,6 +2029,298 @@ void API_NS(base_double_scalarmul_non_secret) (
     assert(contp == ncb_pre); (void)ncb_pre;
 }
 
+void API_NS(base_double_scalarmul_precomputed_non_secret) (
+    point_p combo,
+    const scalar_p scalar1,
+    const API_NS(precomputed_wnaf_p) base2,
+    const scalar_p scalar2
+) {
+    const int table_bits_var = GOLDILOCKS_WNAF_PREPARED_TABLE_BITS,
+        table_bits_pre = GOLDILOCKS_WNAF_FIXED_TABLE_BITS;
+    const niels_p *precmp_var = (const niels_p *)base2->table;
+    int contp=0, contv=0, i;
+    struct smvt_control control_var[SCALAR_BITS/(table_bits_var+1)+3];
+    struct smvt_control control_pre[SCALAR_BITS/(table_bits_pre+1)+3];
+
+    int ncb_pre = recode_wnaf(control_pre, scalar1, table_bits_pre);
+    int ncb_var = recode_wnaf(control_var, scalar2, table_bits_var);
+
+    i = control_var[0].power;
+
+    if (i < 0 && control_pre[0].power < 0) {
+        API_NS(point_copy)(combo, API_NS(point_identity));
+        return;
+    } else if (i > control_pre[0].power) {
+        niels_to_pt(combo, precmp_var[control_var[0].addend >> 1]);
+        contv++;
+    } else if (i == control_pre[0].power) {
+        niels_to_pt(combo, precmp_var[control_var[0].addend >> 1]);
+        add_niels_to_pt(combo, API_NS(wnaf_base)[control_pre[0].addend >> 1], i);
+        contv++; contp++;
+    } else {
+        i = control_pre[0].power;
+        niels_to_pt(combo, API_NS(wnaf_base)[control_pre[0].addend >> 1]);
+        contp++;
+    }
+
+    for (i--; i >= 0; i--) {
+        int cv = (i==control_var[contv].power), cp = (i==control_pre[contp].power);
+        point_double_internal(combo,combo,i && !(cv||cp));
+
+        if (cv) {
+            assert(control_var[contv].addend);
+
+            if (control_var[contv].addend > 0) {
+                add_niels_to_pt(combo, precmp_var[control_var[contv].addend >> 1], i&&!cp);
+            } else {
+                sub_niels_from_pt(combo, precmp_var[(-control_var[contv].addend) >> 1], i&&!cp);
+            }
+            contv++;
+        }
+
+        if (cp) {
+            assert(control_pre[contp].addend);
+
+            if (control_pre[contp].addend > 0) {
+                add_niels_to_pt(combo, API_NS(wnaf_base)[control_pre[contp].addend >> 1], i);
+            } else {
+                sub_niels_from_pt(combo, API_NS(wnaf_base)[(-control_pre[contp].addend) >> 1], i);
+            }
+            contp++;
+        }
+    }
+
+    assert(contv == ncb_var); (void)ncb_var;
+    assert(contp == ncb_pre); (void)ncb_pre;
+}
+
+/* Largest bucket window of the Pippenger multi-scalar multiply */
+#define GOLDILOCKS_PIPPENGER_MAX_BITS 16
+
+static goldilocks_error_t multiscalarmul_straus (
+    point_p out,
+    const point_p *points,
+    const scalar_p *scalars,
+    size_t n
+) {
+    const int table_bits = GOLDILOCKS_WNAF_VAR_TABLE_BITS,
+        control_size = SCALAR_BITS/(table_bits+1)+3;
+    struct smvt_control *control;
+    pniels_p *precmp;
+    size_t *cont;
+    size_t j, last;
+    int i, top = -1, started = 0;
+
+    /* Interleave the wNAFs of all the points */
+    control = (struct smvt_control *)malloc(n * control_size * sizeof(*control));
+    cont = (size_t *)malloc(n * sizeof(*cont));
+    precmp = (pniels_p *)malloc_vector(n * sizeof(pniels_p) << table_bits);
+    if (!control || !cont || !precmp) {
+        free(control);
+        free(cont);
+        free(precmp);
+        return GOLDILOCKS_FAILURE;
+    }
+
+    for (j=0; j<n; j++) {
+        recode_wnaf(&control[j*control_size], scalars[j], table_bits);
+        prepare_wnaf_table(&precmp[j<<table_bits], points[j], table_bits);
+        cont[j] = j*control_size;
+        if (control[cont[j]].power > top) top = control[cont[j]].power;
+    }
+
+    API_NS(point_copy)(out, API_NS(point_identity));
+    for (i=top; i>=0; i--) {
+        last = n;
+        for (j=0; j<n; j++) {
+            if (control[cont[j]].power == i) last = j;
+        }
+
+        if (started) point_double_internal(out,out,i && last == n);
+
+        for (j=0; j<n; j++) {
+            int addend = control[cont[j]].addend;
+            if (control[cont[j]].power != i) continue;
+            assert(addend);
+
+            if (!started) {
+                assert(addend > 0);
+                pniels_to_pt(out, precmp[(j<<table_bits) + (addend >> 1)]);
+                started = 1;
+            } else if (addend > 0) {
+                add_pniels_to_pt(out, precmp[(j<<table_bits) + (addend >> 1)], i && j == last);
+            } else {
+                sub_pniels_from_pt(out, precmp[(j<<table_bits) + ((-addend) >> 1)], i && j == last);
+            }
+            cont[j]++;
+        }
+    }
+
+    /* This function is non-secret, but whatever this is cheap. */
+    goldilocks_bzero(control, n * control_size * sizeof(*control));
+    goldilocks_bzero(precmp, n * sizeof(pniels_p) << table_bits);
+    free(control);
+    free(cont);
+    free(precmp);
+    return GOLDILOCKS_SUCCESS;
+}
+
+/* Signed (Booth) digit of the scalar for the window of the given bits at pos,
+ * in [-2^(bits-1), 2^(bits-1)]
+ */
+static int pippenger_digit (
+    const scalar_p scalar,
+    int pos,
+    unsigned int bits
+) {
+    int v = 0, b;
+    unsigned int k;
+    for (k=0; k<=bits; k++) {
+        b = pos-1+(int)k;
+        if (b >= 0 && b < SCALAR_BITS) {
+            v |= ((scalar->limb[b/WBITS] >> (b%WBITS)) & 1) << k;
+        }
+    }
+    return (v>>1) + (v&1) - (((v>>bits) & 1) << bits);
+}
+
+static goldilocks_error_t multiscalarmul_pippenger (
+    point_p out,
+    const point_p *points,
+    const scalar_p *scalars,
+    size_t n,
+    unsigned int bits,
+    unsigned int nbits
+) {
+    const unsigned int nbuckets = 1u<<(bits-1), nwindows = (nbits+bits)/bits;
+    pniels_p *pre;
+    point_p *buckets, sum, acc;
+    uint8_t *filled;
+    unsigned int k;
+    size_t j;
+    int w, d, started = 0, summed, accumulated;
+
+    pre = (pniels_p *)malloc_vector(n * sizeof(pniels_p));
+    buckets = (point_p *)malloc_vector(nbuckets * sizeof(point_p));
+    filled = (uint8_t *)malloc(nbuckets);
+    if (!pre || !buckets || !filled) {
+        free(pre);
+        free(buckets);
+        free(filled);
+        return GOLDILOCKS_FAILURE;
+    }
+
+    for (j=0; j<n; j++) {
+        pt_to_pniels(pre[j], points[j]);
+    }
+
+    API_NS(point_copy)(out, API_NS(point_identity));
+    for (w=nwindows-1; w>=0; w--) {
+        if (started) {
+            for (k=0; k<bits; k++) point_double_internal(out,out,k<bits-1);
+        }
+
+        /* Sort the points into buckets by digit */
+        memset(filled, 0, nbuckets);
+        for (j=0; j<n; j++) {
+            d = pippenger_digit(scalars[j], w*bits, bits);
+            if (d > 0) {
+                if (filled[d-1]) {
+                    add_pniels_to_pt(buckets[d-1], pre[j], 0);
+                } else {
+                    pniels_to_pt(buckets[d-1], pre[j]);
+                    filled[d-1] = 1;
+                }
+            } else if (d < 0) {
+                if (filled[-d-1]) {
+                    sub_pniels_from_pt(buckets[-d-1], pre[j], 0);
+                } else {
+                    pniels_to_pt(buckets[-d-1], pre[j]);
+                    API_NS(point_negate)(buckets[-d-1], buckets[-d-1]);
+                    filled[-d-1] = 1;
+                }
+            }
+        }
+
+        /* acc = sum (k+1)*buckets[k], by running sums from the top */
+        summed = accumulated = 0;
+        for (k=nbuckets; k-- > 0; ) {
+            if (filled[k]) {
+                if (summed) API_NS(point_add)(sum, sum, buckets[k]);
+                else API_NS(point_copy)(sum, buckets[k]);
+                summed = 1;
+            }
+            if (summed) {
+                if (accumulated) API_NS(point_add)(acc, acc, sum);
+                else API_NS(point_copy)(acc, sum);
+                accumulated = 1;
+            }
+        }
+
+        if (accumulated) {
+            if (started) API_NS(point_add)(out, out, acc);
+            else API_NS(point_copy)(out, acc);
+            started = 1;
+        }
+    }
+
+    /* This function is non-secret, but whatever this is cheap. */
+    goldilocks_bzero(pre, n * sizeof(pniels_p));
+    goldilocks_bzero(buckets, nbuckets * sizeof(point_p));
+    API_NS(point_destroy)(sum);
+    API_NS(point_destroy)(acc);
+    free(pre);
+    free(buckets);
+    free(filled);
+    return GOLDILOCKS_SUCCESS;
+}
+
+goldilocks_error_t API_NS(point_multiscalarmul_non_secret) (
+    point_p out,
+    const point_p *points,
+    const scalar_p *scalars,
+    size_t n
+) {
+    const unsigned int table_bits = GOLDILOCKS_WNAF_VAR_TABLE_BITS;
+    unsigned int bits, best_bits = 0, nbits = 0;
+    size_t j, cost, best_cost;
+    int i;
+
+    if (n == 0) {
+        API_NS(point_copy)(out, API_NS(point_identity));
+        return GOLDILOCKS_SUCCESS;
+    } else if (n > ((size_t)-1) / (sizeof(pniels_p) << table_bits)) {
+        return GOLDILOCKS_FAILURE;
+    }
+
+    /* Length of the longest scalar */
+    for (j=0; j<n; j++) {
+        for (i=SCALAR_LIMBS-1; i>=0 && (int)nbits < (i+1)*WBITS; i--) {
+            if (scalars[j]->limb[i]) {
+                bits = i*WBITS + 64 - __builtin_clzll(scalars[j]->limb[i]);
+                if (bits > nbits) nbits = bits;
+                break;
+            }
+        }
+    }
+
+    /* Estimate the number of additions for Straus vs Pippenger with each window */
+    best_cost = n * ((nbits / (table_bits+2)) + (1u<<table_bits));
+    for (bits=2; bits<=GOLDILOCKS_PIPPENGER_MAX_BITS; bits++) {
+        cost = (size_t)((nbits+bits)/bits) * (n + (1u<<bits));
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_bits = bits;
+        }
+    }
+
+    if (best_bits) {
+        return multiscalarmul_pippenger(out, points, scalars, n, best_bits, nbits);
+    } else {
+        return multiscalarmul_straus(out, points, scalars, n);
+    }
+}
+
 void API_NS(point_destroy) (
     point_p point
 ) {
@@ -24,11 +24,13 @@ static const unsigned char base_point_ser_for_pregen[SER_BYTES] = {
 
  /* To satisfy linker. */
 const gf API_NS(precomputed_base_as_fe)[1];
+const API_NS(scalar_p) API_NS(precomputed_scalarmul_adjustment);
 const API_NS(point_p) API_NS(point_base);
 
 struct niels_s;
 const gf_s *API_NS(precomputed_wnaf_as_fe);
 extern const size_t API_NS(sizeof_precomputed_wnafs);
+extern const unsigned int API_NS(precomputed_comb_bits);
 
 void API_NS(precompute_wnafs) (
     struct niels_s *out,
@@ -56,10 +58,26 @@ static void field_print(const gf f) {
     assert(b<8);
 }
 
+static void scalar_print(const API_NS(scalar_p) sc) {
+    unsigned char ser[SCALAR_SER_BYTES];
+    unsigned long long limb;
+    int i, j;
+    API_NS(scalar_encode)(ser,sc);
+    printf("{{{");
+    for (i=0; i<SCALAR_SER_BYTES; i+=8) {
+        limb = 0;
+        for (j=7; j>=0; j--) limb = limb<<8 | (i+j < SCALAR_SER_BYTES ? ser[i+j] : 0);
+        if (i) printf(", ");
+        printf("SC_LIMB(0x%016llx)", limb);
+    }
+    printf("}}}");
+}
+
 int main(int argc, char **argv) {
     API_NS(point_p) real_point_base;
     int ret;
     API_NS(precomputed_s) *pre;
+    API_NS(scalar_p) adjustment;
     const gf_s *output;
     unsigned i;
     struct niels_s *pre_wnaf;
@@ -110,6 +128,18 @@ int main(int argc, char **argv) {
     }
     printf("\n};\n");
 
+    /* 2^(comb bits) - 1: makes every comb digit +-1, see precomputed_scalarmul */
+    API_NS(scalar_copy)(adjustment, API_NS(scalar_one));
+    for (i=0; i < API_NS(precomputed_comb_bits); i++) {
+        API_NS(scalar_add)(adjustment, adjustment, adjustment);
+    }
+    API_NS(scalar_sub)(adjustment, adjustment, API_NS(scalar_one));
+
+    printf("const API_NS(scalar_p) API_NS(precomputed_scalarmul_adjustment)\n");
+    printf("__attribute__((visibility(\"hidden\"))) = ");
+    scalar_print(adjustment);
+    printf(";\n\n");
+
     output = (const gf_s *)pre_wnaf;
     printf("const gf API_NS(precomputed_wnaf_as_fe)[%d]\n",
         (int)(API_NS(sizeof_precomputed_wnafs) / sizeof(gf)));
@@ -7,13 +7,23 @@
 #define __ARCH_X86_64_ARCH_INTRINSICS_H__
 
 #define ARCH_WORD_BITS 64
+#define ARCH_HAS_GF4 1 /* arch_x86_64/f_impl4.c, AVX2 checked at runtime */
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#define ARCH_HAS_GF8 1 /* arch_x86_64/f_impl8.c, AVX-512 IFMA checked at runtime */
+#endif
+#define ARCH_HAS_WIDE_LOOKUP 1 /* arch_x86_64/ct_lookup.c, AVX2 and AVX-512 checked at runtime */
 
 #include <stdint.h>
 
+/* The runtime dispatch build sets GOLDILOCKS_WIDEMUL_MULX to get mulx without -mbmi2. */
+#ifndef GOLDILOCKS_WIDEMUL_MULX
+#define GOLDILOCKS_WIDEMUL_MULX 0
+#endif
+
 /* FUTURE: autogenerate */
 static __inline__ __uint128_t widemul(const uint64_t *a, const uint64_t *b) {
   uint64_t c,d;
-  #ifndef __BMI2__
+  #if !defined(__BMI2__) && !GOLDILOCKS_WIDEMUL_MULX
       __asm__ volatile
           ("movq %[a], %%rax;"
            "mulq %[b];"
@@ -33,7 +43,7 @@ static __inline__ __uint128_t widemul(const uint64_t *a, const uint64_t *b) {
 
 static __inline__ __uint128_t widemul_rm(uint64_t a, const uint64_t *b) {
   uint64_t c,d;
-  #ifndef __BMI2__
+  #if !defined(__BMI2__) && !GOLDILOCKS_WIDEMUL_MULX
       __asm__ volatile
           ("movq %[a], %%rax;"
            "mulq %[b];"
@@ -51,7 +61,7 @@ static __inline__ __uint128_t widemul_rm(uint64_t a, const uint64_t *b) {
 
 static __inline__ __uint128_t widemul_rr(uint64_t a, uint64_t b) {
   uint64_t c,d;
-  #ifndef __BMI2__
+  #if !defined(__BMI2__) && !GOLDILOCKS_WIDEMUL_MULX
       __asm__ volatile
           ("mulq %[b];"
            : [c]"=a"(c), [d]"=d"(d)
@@ -68,7 +78,7 @@ static __inline__ __uint128_t widemul_rr(uint64_t a, uint64_t b) {
 
 static __inline__ __uint128_t widemul2(const uint64_t *a, const uint64_t *b) {
   uint64_t c,d;
-  #ifndef __BMI2__
+  #if !defined(__BMI2__) && !GOLDILOCKS_WIDEMUL_MULX
       __asm__ volatile
           ("movq %[a], %%rax; "
            "addq %%rax, %%rax; "
@@ -91,7 +101,7 @@ static __inline__ __uint128_t widemul2(const uint64_t *a, const uint64_t *b) {
 static __inline__ void mac(__uint128_t *acc, const uint64_t *a, const uint64_t *b) {
   uint64_t lo = *acc, hi = *acc>>64;
   
-  #ifdef __BMI2__
+  #if defined(__BMI2__) || GOLDILOCKS_WIDEMUL_MULX
       uint64_t c,d;
       __asm__ volatile
           ("movq %[a], %%rdx; "
@@ -119,7 +129,7 @@ static __inline__ void macac(__uint128_t *acc, __uint128_t *acc2, const uint64_t
   uint64_t lo = *acc, hi = *acc>>64;
   uint64_t lo2 = *acc2, hi2 = *acc2>>64;
   
-  #ifdef __BMI2__
+  #if defined(__BMI2__) || GOLDILOCKS_WIDEMUL_MULX
       uint64_t c,d;
       __asm__ volatile
           ("movq %[a], %%rdx; "
@@ -151,7 +161,7 @@ static __inline__ void macac(__uint128_t *acc, __uint128_t *acc2, const uint64_t
 static __inline__ void mac_rm(__uint128_t *acc, uint64_t a, const uint64_t *b) {
   uint64_t lo = *acc, hi = *acc>>64;
   
-  #ifdef __BMI2__
+  #if defined(__BMI2__) || GOLDILOCKS_WIDEMUL_MULX
       uint64_t c,d;
       __asm__ volatile
           ("mulx %[b], %[c], %[d]; "
@@ -177,7 +187,7 @@ static __inline__ void mac_rm(__uint128_t *acc, uint64_t a, const uint64_t *b) {
 static __inline__ void mac_rr(__uint128_t *acc, uint64_t a, const uint64_t b) {
   uint64_t lo = *acc, hi = *acc>>64;
   
-  #ifdef __BMI2__
+  #if defined(__BMI2__) || GOLDILOCKS_WIDEMUL_MULX
       uint64_t c,d;
       __asm__ volatile
           ("mulx %[b], %[c], %[d]; "
@@ -202,7 +212,7 @@ static __inline__ void mac_rr(__uint128_t *acc, uint64_t a, const uint64_t b) {
 static __inline__ void mac2(__uint128_t *acc, const uint64_t *a, const uint64_t *b) {
   uint64_t lo = *acc, hi = *acc>>64;
   
-  #ifdef __BMI2__
+  #if defined(__BMI2__) || GOLDILOCKS_WIDEMUL_MULX
       uint64_t c,d;
       __asm__ volatile
           ("movq %[a], %%rdx; "
@@ -230,7 +240,7 @@ static __inline__ void mac2(__uint128_t *acc, const uint64_t *a, const uint64_t
 
 static __inline__ void msb(__uint128_t *acc, const uint64_t *a, const uint64_t *b) {
   uint64_t lo = *acc, hi = *acc>>64;
-  #ifdef __BMI2__
+  #if defined(__BMI2__) || GOLDILOCKS_WIDEMUL_MULX
       uint64_t c,d;
       __asm__ volatile
           ("movq %[a], %%rdx; "
@@ -255,7 +265,7 @@ static __inline__ void msb(__uint128_t *acc, const uint64_t *a, const uint64_t *
 
 static __inline__ void msb2(__uint128_t *acc, const uint64_t *a, const uint64_t *b) {
   uint64_t lo = *acc, hi = *acc>>64;
-  #ifdef __BMI2__
+  #if defined(__BMI2__) || GOLDILOCKS_WIDEMUL_MULX
       uint64_t c,d;
       __asm__ volatile
           ("movq %[a], %%rdx; "
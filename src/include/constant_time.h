@@ -123,6 +123,21 @@ constant_time_cond_swap (
     }
 }
 
+#if defined(ARCH_HAS_WIDE_LOOKUP) && ARCH_HAS_WIDE_LOOKUP
+/**
+ * Constant-time lookup with vectors wider than big_register_t, for the
+ * niels and pniels tables, when the CPU has them.  Returns 0 without
+ * touching out if it can't handle this elem_bytes on this CPU.
+ */
+int goldilocks_wide_lookup (
+    void *__restrict__ out,
+    const void *table,
+    word_t elem_bytes,
+    word_t n_table,
+    word_t idx
+);
+#endif
+
 /**
  * @brief Constant-time equivalent of memcpy(out, table + elem_bytes*idx, elem_bytes);
  *
@@ -147,6 +162,10 @@ constant_time_lookup (
     const unsigned char *table = (const unsigned char *)table_;
     word_t j,k,mask;
 
+#if defined(ARCH_HAS_WIDE_LOOKUP) && ARCH_HAS_WIDE_LOOKUP
+    if (elem_bytes % 64 == 0 && goldilocks_wide_lookup(out_, table_, elem_bytes, n_table, idx)) return;
+#endif
+
     memset(out, 0, elem_bytes);
     for (j=0; j<n_table; j++, big_i-=big_one) {
         big_register_t br_mask = br_is_zero(big_i);
@@ -0,0 +1,26 @@
+/**
+ * @file cpu_features.h
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * @brief Run-time CPU feature detection, shared by everything that dispatches on it.
+ */
+
+#ifndef __CPU_FEATURES_H__
+#define __CPU_FEATURES_H__ 1
+
+#define GOLDILOCKS_CPU_BMI2 1 /* mulx */
+#define GOLDILOCKS_CPU_AVX2 2 /* gf4, keccakf_x4 */
+#define GOLDILOCKS_CPU_IFMA 4 /* gf8 */
+#define GOLDILOCKS_CPU_AVX512 8 /* constant_time_lookup, keccakf_x8 */
+
+/**
+ * The GOLDILOCKS_CPU_* features this CPU has, limited by the
+ * GOLDILOCKS_CPU environment variable if it is set, to one of
+ * "generic", "bmi2", "avx2", "avx512" or "avx512ifma".  Any other
+ * value is taken as "generic".  Always 0 except on x86_64.
+ */
+unsigned int goldilocks_cpu_features (void);
+
+#endif /* __CPU_FEATURES_H__ */
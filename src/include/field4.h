@@ -0,0 +1,117 @@
+/**
+ * @file field4.h
+ * @brief Four-way parallel gf header.
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * A gf4 holds four independent field elements, and each operation acts
+ * on all four lanes at once.  On x86_64 they are kept in radix 2^28, with
+ * limb i of each element in the same ymm register, and the code needs
+ * AVX2, so callers must check gf4_supported().  Elsewhere a gf4 is just
+ * four gfs and the operations are interleaved on them.
+ */
+
+#ifndef __GF4_H__
+#define __GF4_H__ 1
+
+#include "field.h"
+
+#if defined(ARCH_HAS_GF4) && ARCH_HAS_GF4
+#define GF4_VECTORIZED 1
+#else
+#define GF4_VECTORIZED 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if GF4_VECTORIZED
+
+/** Four field elements: lane j of limb[i] is limb i of element j, radix 2^28. */
+typedef struct gf4_s {
+    uint64x4_t limb[16];
+} gf4_s, gf4[1];
+
+/** Return nonzero if this CPU can run the gf4 functions. */
+int gf4_supported (void);
+
+void gf4_add (gf4 out, const gf4 a, const gf4 b);
+void gf4_sub (gf4 out, const gf4 a, const gf4 b);
+void gf4_mul (gf4_s *__restrict__ out, const gf4 a, const gf4 b);
+void gf4_sqr (gf4_s *__restrict__ out, const gf4 a);
+void gf4_mulw_unsigned (gf4_s *__restrict__ out, const gf4 a, uint32_t w);
+
+/** Load lanes 0..3 of out from a, b, c, d. */
+void gf4_load (gf4 out, const gf a, const gf b, const gf c, const gf d);
+
+/** Store lanes 0..3 of in to a, b, c, d. */
+void gf4_store (gf a, gf b, gf c, gf d, const gf4 in);
+
+/** Constant time, if (swap[j]) swap lane j of x and y. */
+void gf4_cond_swap (gf4 x, gf4_s *__restrict__ y, const mask_t swap[4]);
+
+#else /* !GF4_VECTORIZED */
+
+/** Four field elements. */
+typedef struct gf4_s {
+    gf lane[4];
+} gf4_s, gf4[1];
+
+static GOLDILOCKS_INLINE int gf4_supported (void) {
+    return 1;
+}
+
+static GOLDILOCKS_INLINE void gf4_add (gf4 out, const gf4 a, const gf4 b) {
+    unsigned int j;
+    for (j=0; j<4; j++) gf_add(out->lane[j], a->lane[j], b->lane[j]);
+}
+
+static GOLDILOCKS_INLINE void gf4_sub (gf4 out, const gf4 a, const gf4 b) {
+    unsigned int j;
+    for (j=0; j<4; j++) gf_sub(out->lane[j], a->lane[j], b->lane[j]);
+}
+
+static GOLDILOCKS_INLINE void gf4_mul (gf4_s *__restrict__ out, const gf4 a, const gf4 b) {
+    unsigned int j;
+    for (j=0; j<4; j++) gf_mul(out->lane[j], a->lane[j], b->lane[j]);
+}
+
+static GOLDILOCKS_INLINE void gf4_sqr (gf4_s *__restrict__ out, const gf4 a) {
+    unsigned int j;
+    for (j=0; j<4; j++) gf_sqr(out->lane[j], a->lane[j]);
+}
+
+static GOLDILOCKS_INLINE void gf4_mulw_unsigned (gf4_s *__restrict__ out, const gf4 a, uint32_t w) {
+    unsigned int j;
+    for (j=0; j<4; j++) gf_mulw_unsigned(out->lane[j], a->lane[j], w);
+}
+
+static GOLDILOCKS_INLINE void gf4_load (gf4 out, const gf a, const gf b, const gf c, const gf d) {
+    gf_copy(out->lane[0], a);
+    gf_copy(out->lane[1], b);
+    gf_copy(out->lane[2], c);
+    gf_copy(out->lane[3], d);
+}
+
+static GOLDILOCKS_INLINE void gf4_store (gf a, gf b, gf c, gf d, const gf4 in) {
+    gf_copy(a, in->lane[0]);
+    gf_copy(b, in->lane[1]);
+    gf_copy(c, in->lane[2]);
+    gf_copy(d, in->lane[3]);
+}
+
+static GOLDILOCKS_INLINE void
+gf4_cond_swap (gf4 x, gf4_s *__restrict__ y, const mask_t swap[4]) {
+    unsigned int j;
+    for (j=0; j<4; j++) gf_cond_swap(x->lane[j], y->lane[j], swap[j]);
+}
+
+#endif /* GF4_VECTORIZED */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __GF4_H__ */
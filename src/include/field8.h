@@ -0,0 +1,66 @@
+/**
+ * @file field8.h
+ * @brief Eight-way parallel gf header, for AVX-512 IFMA.
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * A gf8 holds eight independent field elements, one per 64-bit lane of a
+ * zmm register, in radix 2^52 so that vpmadd52luq/vpmadd52huq can do the
+ * multiplies.  The instructions are only used if the CPU has them, so
+ * callers must check gf8_supported() and otherwise fall back to gf or gf4.
+ */
+
+#ifndef __GF8_H__
+#define __GF8_H__ 1
+
+#include "field.h"
+
+#if defined(ARCH_HAS_GF8) && ARCH_HAS_GF8
+#define GF8_VECTORIZED 1
+#else
+#define GF8_VECTORIZED 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if GF8_VECTORIZED
+
+/**
+ * Eight field elements: lane j of limb[i] is limb i of element j, radix 2^52.
+ * Every limb is below 2^52 between operations, and the top one below 2^34.
+ */
+typedef struct gf8_s {
+    uint64x8_t limb[9];
+} gf8_s, gf8[1];
+
+/** Return nonzero if this CPU can run the gf8 functions. */
+int gf8_supported (void);
+
+void gf8_add (gf8 out, const gf8 a, const gf8 b);
+void gf8_sub (gf8 out, const gf8 a, const gf8 b);
+void gf8_mul (gf8_s *__restrict__ out, const gf8 a, const gf8 b);
+void gf8_sqr (gf8_s *__restrict__ out, const gf8 a);
+void gf8_mulw_unsigned (gf8_s *__restrict__ out, const gf8 a, uint32_t w);
+
+/** Carry the limbs of a back below 2^52. */
+void gf8_weak_reduce (gf8 a);
+
+/** Load lane j of out from in[j]. */
+void gf8_load (gf8 out, const gf_s in[8]);
+
+/** Store lane j of in to out[j]. */
+void gf8_store (gf_s out[8], const gf8 in);
+
+/** Constant time, if (swap[j]) swap lane j of x and y. */
+void gf8_cond_swap (gf8 x, gf8_s *__restrict__ y, const mask_t swap[8]);
+
+#endif /* GF8_VECTORIZED */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __GF8_H__ */
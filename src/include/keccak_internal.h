@@ -13,7 +13,8 @@
 
 #include <stdint.h>
 
-/* The internal, non-opaque definition of the goldilocks_sponge struct. */
+/* The internal, non-opaque definition of the goldilocks_sponge struct.
+ * The lanes are kept in native byte order. */
 typedef union {
     uint64_t w[25]; uint8_t b[25*8];
 } kdomain_u[1];
@@ -31,6 +32,14 @@ typedef struct goldilocks_keccak_sponge_s {
 
 void __attribute__((noinline)) keccakf(kdomain_u state, uint8_t start_round);
 
+/*
+ * Four or eight independent states side by side, so that the permutation
+ * can run on SIMD registers: lane i of state j is state[i*4+j] (or
+ * state[i*8+j]).
+ */
+void keccakf_x4(uint64_t state[25*4], uint8_t start_round);
+void keccakf_x8(uint64_t state[25*8], uint8_t start_round);
+
 static inline void dokeccak (goldilocks_keccak_sponge_p goldilocks_sponge) {
     keccakf(goldilocks_sponge->state, goldilocks_sponge->params->start_round);
     goldilocks_sponge->params->position = 0;
@@ -0,0 +1,37 @@
+/**
+ * @file safegcd.h
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * @brief Constant-time modular inversion by Bernstein-Yang divsteps.
+ */
+
+#ifndef __SAFEGCD_H__
+#define __SAFEGCD_H__ 1
+
+#include "word.h"
+
+/** Length of the little-endian numbers taken by goldilocks_safegcd_invert. */
+#define SAFEGCD_BYTES 56
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Set out = 1/in mod modulus, or 0 if in is 0.  The modulus must be odd,
+ * and in must be less than it.  Takes the same time for every input.
+ * The input and output may alias.
+ */
+void goldilocks_safegcd_invert (
+    uint8_t out[SAFEGCD_BYTES],
+    const uint8_t in[SAFEGCD_BYTES],
+    const uint8_t modulus[SAFEGCD_BYTES]
+);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __SAFEGCD_H__ */
@@ -76,6 +76,8 @@ extern int posix_memalign(void **, size_t, size_t);
     typedef int64_t  int64x2_t __attribute__((ext_vector_type(2)));
     typedef uint64_t uint64x4_t __attribute__((ext_vector_type(4)));
     typedef int64_t  int64x4_t __attribute__((ext_vector_type(4)));
+    typedef uint64_t uint64x8_t __attribute__((ext_vector_type(8)));
+    typedef int64_t  int64x8_t __attribute__((ext_vector_type(8)));
     typedef uint32_t uint32x4_t __attribute__((ext_vector_type(4)));
     typedef int32_t  int32x4_t __attribute__((ext_vector_type(4)));
     typedef uint32_t uint32x2_t __attribute__((ext_vector_type(2)));
@@ -88,6 +90,8 @@ extern int posix_memalign(void **, size_t, size_t);
     typedef int64_t  int64x2_t __attribute__((vector_size(16)));
     typedef uint64_t uint64x4_t __attribute__((vector_size(32)));
     typedef int64_t  int64x4_t __attribute__((vector_size(32)));
+    typedef uint64_t uint64x8_t __attribute__((vector_size(64)));
+    typedef int64_t  int64x8_t __attribute__((vector_size(64)));
     typedef uint32_t uint32x4_t __attribute__((vector_size(16)));
     typedef int32_t  int32x4_t __attribute__((vector_size(16)));
     typedef uint32_t uint32x2_t __attribute__((vector_size(8)));
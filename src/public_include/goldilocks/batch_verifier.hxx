@@ -0,0 +1,326 @@
+/**
+ * @file goldilocks/batch_verifier.hxx
+ *
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * @brief A thread pool for verifying streams of EdDSA signatures.  C++11 only.
+ */
+
+#ifndef __GOLDILOCKS_BATCH_VERIFIER_HXX__
+#define __GOLDILOCKS_BATCH_VERIFIER_HXX__ 1
+
+#include <goldilocks/ed448.hxx>
+
+#if __cplusplus < 201103L
+#error "goldilocks/batch_verifier.hxx requires C++11"
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Namespace for all libgoldilocks C++ objects. */
+namespace goldilocks {
+
+/**
+ * Verifies a stream of Ed448 signatures on a pool of threads.
+ *
+ * Submitted signatures are collected into sub-batches, which are checked
+ * with goldilocks_ed448_verify_batch.  Each sub-batch goes to the next
+ * worker's queue in turn, and a worker whose queue is empty steals from the
+ * others.  A sub-batch is sent off when it is full, or straight away if a
+ * worker is idle and no other work is queued, so that a lightly loaded
+ * verifier doesn't hold signatures back.  Call flush() to send off a
+ * partial sub-batch.
+ *
+ * Each result is what goldilocks_ed448_verify would have returned, and is
+ * reported through a future or a callback.  The key, signature, message and
+ * context are copied, so they need not outlive the call to submit.  Any
+ * thread may submit.
+ */
+class BatchVerifier {
+public:
+    /** Public key type */
+    typedef EdDSA<Ed448Goldilocks>::PublicKey PublicKey;
+
+    /** Signature size. */
+    static const size_t SIG_BYTES = GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES;
+
+    /** Default number of signatures in a sub-batch. */
+    static const size_t DEFAULT_SUB_BATCH = 64;
+
+    /**
+     * Called with the result of a verification, on a worker thread.  Should
+     * not throw; if it does, the rest of its sub-batch fails.
+     */
+    typedef std::function<void(goldilocks_error_t)> Callback;
+
+private:
+/** @cond internal */
+    struct Job {
+        uint8_t pub[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES];
+        uint8_t sig[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES];
+        std::vector<uint8_t> data; /* The message, then the context */
+        size_t message_len;
+        uint8_t context_len;
+        std::promise<goldilocks_error_t> promise;
+        Callback callback;
+    };
+    typedef std::vector<Job> SubBatch;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<SubBatch> queue;
+        std::thread thread;
+    };
+
+    const size_t sub_batch_;
+    std::vector<std::unique_ptr<Worker> > workers_;
+
+    /* mutex_ guards everything below, and is taken before a worker's mutex */
+    std::mutex mutex_;
+    std::condition_variable work_cv_, done_cv_;
+    SubBatch filling_;
+    size_t next_worker_, queued_, pending_, idle_;
+    bool stopping_;
+
+    BatchVerifier(const BatchVerifier &) = delete;
+    BatchVerifier &operator=(const BatchVerifier &) = delete;
+
+    /* Called with mutex_ held */
+    void dispatch() {
+        Worker &w = *workers_[next_worker_];
+        next_worker_ = (next_worker_ + 1) % workers_.size();
+        {
+            std::lock_guard<std::mutex> lock(w.mutex);
+            w.queue.push_back(std::move(filling_));
+        }
+        filling_ = SubBatch();
+        filling_.reserve(sub_batch_);
+        queued_++;
+        work_cv_.notify_one();
+    }
+
+    /* Take from the front of our own queue, or else the back of someone else's */
+    bool take(size_t self, SubBatch &out) {
+        for (size_t i=0; i<workers_.size(); i++) {
+            Worker &w = *workers_[(self+i) % workers_.size()];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (w.queue.empty()) continue;
+            if (i == 0) {
+                out = std::move(w.queue.front());
+                w.queue.pop_front();
+            } else {
+                out = std::move(w.queue.back());
+                w.queue.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void run(SubBatch &batch) {
+        const size_t n = batch.size();
+        size_t done = 0;
+
+        try {
+            std::vector<goldilocks_ed448_verify_item_s> items(n);
+            std::vector<goldilocks_error_t> results(n);
+
+            for (size_t i=0; i<n; i++) {
+                const Job &job = batch[i];
+                items[i].signature = job.sig;
+                items[i].pubkey = job.pub;
+                items[i].message = job.data.data();
+                items[i].message_len = job.message_len;
+                items[i].prehashed = 0;
+                items[i].context = job.data.data() + job.message_len;
+                items[i].context_len = job.context_len;
+            }
+            (void)goldilocks_ed448_verify_batch(&results[0], &items[0], n);
+
+            while (done < n) {
+                Job &job = batch[done];
+                goldilocks_error_t result = results[done++];
+                if (job.callback) job.callback(result);
+                else job.promise.set_value(result);
+            }
+        } catch (...) {
+            /* Out of memory, or a callback threw: fail everything not yet reported */
+            std::exception_ptr error = std::current_exception();
+            for (; done < n; done++) {
+                Job &job = batch[done];
+                try {
+                    if (job.callback) job.callback(GOLDILOCKS_FAILURE);
+                    else job.promise.set_exception(error);
+                } catch (...) {}
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ -= n;
+        if (pending_ == 0) done_cv_.notify_all();
+    }
+
+    void work(size_t self) {
+        SubBatch batch;
+        for (;;) {
+            if (take(self, batch)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    queued_--;
+                }
+                run(batch);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_++;
+            work_cv_.wait(lock, [this] { return queued_ > 0 || stopping_; });
+            idle_--;
+            if (queued_ == 0 && stopping_) return;
+        }
+    }
+
+    void add(
+        const PublicKey &pub,
+        const FixedBlock<SIG_BYTES> &sig,
+        const Block &message,
+        const Block &context,
+        Job &job
+    ) /*throw(LengthException,std::bad_alloc)*/ {
+        if (context.size() > 255) {
+            throw LengthException();
+        }
+
+        pub.serialize_into(job.pub);
+        memcpy(job.sig, sig.data(), sizeof(job.sig));
+        job.data.reserve(message.size() + context.size());
+        job.data.insert(job.data.end(), message.data(), message.data() + message.size());
+        job.data.insert(job.data.end(), context.data(), context.data() + context.size());
+        job.message_len = message.size();
+        job.context_len = context.size();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        filling_.push_back(std::move(job));
+        pending_++;
+        if (filling_.size() >= sub_batch_ || (idle_ > 0 && queued_ == 0)) dispatch();
+    }
+/** @endcond */
+
+public:
+    /**
+     * Start the worker threads.
+     * @param [in] threads The number of workers, or 0 for one per hardware thread.
+     * @param [in] sub_batch The largest number of signatures to check at once.
+     */
+    inline explicit BatchVerifier(
+        unsigned int threads = 0,
+        size_t sub_batch = DEFAULT_SUB_BATCH
+    ) : sub_batch_(sub_batch ? sub_batch : 1),
+        next_worker_(0), queued_(0), pending_(0), idle_(0), stopping_(false)
+    {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+
+        filling_.reserve(sub_batch_);
+        for (unsigned int i=0; i<threads; i++) {
+            workers_.push_back(std::unique_ptr<Worker>(new Worker));
+        }
+        try {
+            for (unsigned int i=0; i<threads; i++) {
+                workers_[i]->thread = std::thread(&BatchVerifier::work, this, i);
+            }
+        } catch (...) {
+            /* Stop the workers that did start before giving up */
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+                work_cv_.notify_all();
+            }
+            for (size_t i=0; i<workers_.size(); i++) {
+                if (workers_[i]->thread.joinable()) workers_[i]->thread.join();
+            }
+            throw;
+        }
+    }
+
+    /** Finish all the submitted signatures and stop the worker threads. */
+    inline ~BatchVerifier() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!filling_.empty()) dispatch();
+            stopping_ = true;
+            work_cv_.notify_all();
+        }
+        for (size_t i=0; i<workers_.size(); i++) workers_[i]->thread.join();
+    }
+
+    /** Number of worker threads. */
+    inline size_t threads() const noexcept { return workers_.size(); }
+
+    /**
+     * Submit a signature to be verified.
+     * @param [in] pub The public key.
+     * @param [in] sig The signature.
+     * @param [in] message The signed message.
+     * @param [in] context A context for the signature; must be at most 255 bytes.
+     * @return A future for the result.
+     */
+    inline std::future<goldilocks_error_t> submit (
+        const PublicKey &pub,
+        const FixedBlock<SIG_BYTES> &sig,
+        const Block &message,
+        const Block &context = EdDSA<Ed448Goldilocks>::NO_CONTEXT()
+    ) /*throw(LengthException,std::bad_alloc)*/ {
+        Job job;
+        std::future<goldilocks_error_t> ret = job.promise.get_future();
+        add(pub, sig, message, context, job);
+        return ret;
+    }
+
+    /**
+     * Submit a signature to be verified, calling back with the result.
+     * @param [in] pub The public key.
+     * @param [in] sig The signature.
+     * @param [in] message The signed message.
+     * @param [in] callback Called with the result, on a worker thread.
+     * @param [in] context A context for the signature; must be at most 255 bytes.
+     */
+    inline void submit (
+        const PublicKey &pub,
+        const FixedBlock<SIG_BYTES> &sig,
+        const Block &message,
+        const Callback &callback,
+        const Block &context = EdDSA<Ed448Goldilocks>::NO_CONTEXT()
+    ) /*throw(LengthException,std::bad_alloc)*/ {
+        Job job;
+        job.callback = callback;
+        add(pub, sig, message, context, job);
+    }
+
+    /** Send off the partly filled sub-batch, if any. */
+    inline void flush() /*throw(std::bad_alloc)*/ {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!filling_.empty()) dispatch();
+    }
+
+    /** Flush, then wait until every submitted signature has been verified. */
+    inline void wait() /*throw(std::bad_alloc)*/ {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!filling_.empty()) dispatch();
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+    }
+};
+
+} /* namespace goldilocks */
+
+#endif /* __GOLDILOCKS_BATCH_VERIFIER_HXX__ */
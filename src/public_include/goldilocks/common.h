@@ -112,6 +112,40 @@ goldilocks_bool_t goldilocks_memeq (
     size_t size
 ) GOLDILOCKS_NONNULL GOLDILOCKS_WARN_UNUSED GOLDILOCKS_API_VIS;
 
+/**
+ * @brief Set up a pool of locked memory for small secret buffers.
+ *
+ * After this, goldilocks_secure_malloc serves requests of up to 128 bytes,
+ * such as keys and signatures, from memory which is mlock'ed so that it is
+ * never swapped, and excluded from core dumps where the system allows it.
+ * Each thread caches a few free blocks.  Requests which are larger, or
+ * which don't fit in the pool or under RLIMIT_MEMLOCK, go to malloc.  The
+ * pool can't be disabled again; calling this again does nothing.
+ *
+ * @param [in] max_bytes The most memory the pool may lock.
+ * @retval GOLDILOCKS_FAILURE The address space couldn't be reserved.
+ */
+goldilocks_error_t goldilocks_secure_pool_enable (
+    size_t max_bytes
+) GOLDILOCKS_API_VIS;
+
+/**
+ * Allocate memory for secrets, from the pool if goldilocks_secure_pool_enable
+ * has been called.  Returns NULL on failure, like malloc.
+ */
+void *goldilocks_secure_malloc (
+    size_t size
+) GOLDILOCKS_WARN_UNUSED GOLDILOCKS_API_VIS;
+
+/**
+ * Zeroize and free memory from goldilocks_secure_malloc.  The size must be
+ * the size that was allocated.  p may be NULL.
+ */
+void goldilocks_secure_free (
+    void *p,
+    size_t size
+) GOLDILOCKS_API_VIS;
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -51,6 +51,22 @@ extern "C" {
 /** EdDSA decoding ratio. */
 #define GOLDILOCKS_448_EDDSA_DECODE_RATIO (4 / 4)
 
+/**
+ * @brief An EdDSA private key after expansion: everything that signing needs,
+ * so that it doesn't have to hash the private key again for each signature.
+ * Treat this as secret, and clear it with goldilocks_ed448_expanded_key_destroy.
+ */
+typedef struct goldilocks_ed448_expanded_key_s {
+    /** @cond internal */
+    /** The clamped secret scalar. */
+    goldilocks_448_scalar_p secret_scalar;
+    /** The second half of the private key hash, used to derive nonces. */
+    uint8_t seed[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES];
+    /** @endcond */
+    /** The encoded public key. */
+    uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES];
+} goldilocks_ed448_expanded_key_s, goldilocks_ed448_expanded_key_p[1];
+
 /**
  * @brief EdDSA key secret key generation.  This function uses a different (non-Decaf)
  * encoding. It is used for libotrv4.
@@ -75,6 +91,21 @@ void goldilocks_ed448_derive_public_key (
     const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
 ) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief EdDSA key generation for many private keys.  Gives the same output
+ * as goldilocks_ed448_derive_public_key on each, but hashes the keys four
+ * at a time and shares one field inversion across a block of them.
+ *
+ * @param [out] pubkey The public keys, n*GOLDILOCKS_EDDSA_448_PUBLIC_BYTES bytes.
+ * @param [in] privkey The private keys, n*GOLDILOCKS_EDDSA_448_PRIVATE_BYTES bytes.
+ * @param [in] n The number of keys.
+ */
+void goldilocks_ed448_derive_public_key_batch (
+    uint8_t *pubkey,
+    const uint8_t *privkey,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
 /**
  * @brief EdDSA signing.
  *
@@ -127,6 +158,66 @@ void goldilocks_ed448_sign_prehash (
     uint8_t context_len
 ) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2,3,4))) GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief Expand an EdDSA private key for repeated signing.  This hashes the
+ * private key, decodes the secret scalar and derives the public key, once.
+ *
+ * @param [out] expanded The expanded key.
+ * @param [in] privkey The private key.
+ */
+void goldilocks_ed448_expand_private_key (
+    goldilocks_ed448_expanded_key_p expanded,
+    const uint8_t privkey[GOLDILOCKS_EDDSA_448_PRIVATE_BYTES]
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Securely erase an expanded private key.
+ *
+ * @param [out] expanded The expanded key to erase.
+ */
+void goldilocks_ed448_expanded_key_destroy (
+    goldilocks_ed448_expanded_key_p expanded
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief EdDSA signing with an expanded private key.  Produces the same
+ * signature as goldilocks_ed448_sign with the private key it was expanded from.
+ *
+ * @param [out] signature The signature.
+ * @param [in] expanded The expanded private key.
+ * @param [in] message The message to sign.
+ * @param [in] message_len The length of the message.
+ * @param [in] prehashed Nonzero if the message is actually the hash of something you want to sign.
+ * @param [in] context A "context" for this signature of up to 255 bytes.
+ * @param [in] context_len Length of the context.
+ */
+void goldilocks_ed448_sign_expanded (
+    uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const goldilocks_ed448_expanded_key_p expanded,
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len
+) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2))) GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief EdDSA signing with prehash and an expanded private key.
+ *
+ * @param [out] signature The signature.
+ * @param [in] expanded The expanded private key.
+ * @param [in] hash The hash of the message.  This object will not be modified by the call.
+ * @param [in] context A "context" for this signature of up to 255 bytes.  Must be the same as what was used for the prehash.
+ * @param [in] context_len Length of the context.
+ */
+void goldilocks_ed448_sign_expanded_prehash (
+    uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const goldilocks_ed448_expanded_key_p expanded,
+    const goldilocks_ed448_prehash_ctx_p hash,
+    const uint8_t *context,
+    uint8_t context_len
+) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2,3))) GOLDILOCKS_NOINLINE;
+
 /**
  * @brief Prehash initialization, with contexts if supported.
  *
@@ -188,6 +279,162 @@ goldilocks_error_t goldilocks_ed448_verify_prehash (
     uint8_t context_len
 ) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2))) GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief EdDSA signature verification by comparing encodings.
+ *
+ * Computes R' = [k]B - [c]A, encodes it, and compares the encoding with R
+ * in constant time.  This needs an inversion instead of the inverse square
+ * root of decoding R, so it is faster when inversion is (see configure
+ * --enable-safegcd).
+ *
+ * It is also stricter than goldilocks_ed448_verify: R must be exactly the
+ * canonical encoding of R', so signatures whose R has been changed by a
+ * small-order point, or encoded non-canonically, are rejected.  Signatures
+ * made by goldilocks_ed448_sign always pass both.
+ *
+ * @param [in] signature The signature.
+ * @param [in] pubkey The public key.
+ * @param [in] message The message to verify.
+ * @param [in] message_len The length of the message.
+ * @param [in] prehashed Nonzero if the message is actually the hash of something you want to verify.
+ * @param [in] context A "context" for this signature of up to 255 bytes.
+ * @param [in] context_len Length of the context.
+ */
+goldilocks_error_t goldilocks_ed448_verify_strict (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len
+) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2))) GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief EdDSA signature verification with prehash, by comparing encodings.
+ * See goldilocks_ed448_verify_strict.
+ *
+ * @param [in] signature The signature.
+ * @param [in] pubkey The public key.
+ * @param [in] hash The hash of the message.  This object will not be modified by the call.
+ * @param [in] context A "context" for this signature of up to 255 bytes.  Must be the same as what was used for the prehash.
+ * @param [in] context_len Length of the context.
+ */
+goldilocks_error_t goldilocks_ed448_verify_strict_prehash (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES],
+    const goldilocks_ed448_prehash_ctx_p hash,
+    const uint8_t *context,
+    uint8_t context_len
+) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2,3))) GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief An EdDSA public key prepared for repeated verification: the key is
+ * decoded once, and a wNAF table of its multiples is built once.
+ */
+typedef struct goldilocks_ed448_prepared_public_key_s {
+    /** @cond internal */
+    /** Precomputed multiples of the decoded public key. */
+    goldilocks_448_precomputed_wnaf_p table;
+    /** @endcond */
+    /** The encoded public key. */
+    uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES];
+} goldilocks_ed448_prepared_public_key_s, goldilocks_ed448_prepared_public_key_p[1];
+
+/**
+ * @brief Prepare a public key for goldilocks_ed448_verify_prepared.
+ *
+ * @param [out] prepared The prepared public key.
+ * @param [in] pubkey The public key.
+ *
+ * @retval GOLDILOCKS_SUCCESS The public key was prepared.
+ * @retval GOLDILOCKS_FAILURE The public key did not decode.
+ */
+goldilocks_error_t goldilocks_ed448_prepare_public_key (
+    goldilocks_ed448_prepared_public_key_p prepared,
+    const uint8_t pubkey[GOLDILOCKS_EDDSA_448_PUBLIC_BYTES]
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief EdDSA signature verification against a prepared public key.
+ * Gives the same result as goldilocks_ed448_verify, but faster.
+ *
+ * @param [in] signature The signature.
+ * @param [in] prepared The public key, from goldilocks_ed448_prepare_public_key.
+ * @param [in] message The message to verify.
+ * @param [in] message_len The length of the message.
+ * @param [in] prehashed Nonzero if the message is actually the hash of something you want to verify.
+ * @param [in] context A "context" for this signature of up to 255 bytes.
+ * @param [in] context_len Length of the context.
+ */
+goldilocks_error_t goldilocks_ed448_verify_prepared (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const goldilocks_ed448_prepared_public_key_p prepared,
+    const uint8_t *message,
+    size_t message_len,
+    uint8_t prehashed,
+    const uint8_t *context,
+    uint8_t context_len
+) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2))) GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief EdDSA signature verification with prehash against a prepared public key.
+ *
+ * @param [in] signature The signature.
+ * @param [in] prepared The public key, from goldilocks_ed448_prepare_public_key.
+ * @param [in] hash The hash of the message.  This object will not be modified by the call.
+ * @param [in] context A "context" for this signature of up to 255 bytes.  Must be the same as what was used for the prehash.
+ * @param [in] context_len Length of the context.
+ */
+goldilocks_error_t goldilocks_ed448_verify_prepared_prehash (
+    const uint8_t signature[GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES],
+    const goldilocks_ed448_prepared_public_key_p prepared,
+    const goldilocks_ed448_prehash_ctx_p hash,
+    const uint8_t *context,
+    uint8_t context_len
+) GOLDILOCKS_API_VIS __attribute__((nonnull(1,2,3))) GOLDILOCKS_NOINLINE;
+
+/** One signature to be checked by goldilocks_ed448_verify_batch. */
+typedef struct goldilocks_ed448_verify_item_s {
+    /** The signature, GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES long. */
+    const uint8_t *signature;
+    /** The public key, GOLDILOCKS_EDDSA_448_PUBLIC_BYTES long. */
+    const uint8_t *pubkey;
+    /** The message to verify. */
+    const uint8_t *message;
+    /** The length of the message. */
+    size_t message_len;
+    /** Nonzero if the message is actually the hash of something you want to verify. */
+    uint8_t prehashed;
+    /** A "context" for this signature of up to 255 bytes. */
+    const uint8_t *context;
+    /** Length of the context. */
+    uint8_t context_len;
+} goldilocks_ed448_verify_item_s;
+
+/**
+ * @brief EdDSA batch signature verification.
+ *
+ * Checks all the signatures at once with a random linear combination of their
+ * verification equations, evaluated as a single multi-scalar multiplication.
+ * The random coefficients are derived by hashing the whole batch.  If the
+ * combined check fails and results is non-NULL, the batch is bisected to find
+ * which signatures are bad.  Each result is the same as what goldilocks_ed448_verify
+ * would have returned for that item.
+ *
+ * @param [out] results If non-NULL, the verification result for each item.
+ * @param [in] items The signatures to verify.
+ * @param [in] n The number of items.
+ *
+ * @retval GOLDILOCKS_SUCCESS All signatures are valid.
+ * @retval GOLDILOCKS_FAILURE At least one signature is invalid.
+ */
+goldilocks_error_t goldilocks_ed448_verify_batch (
+    goldilocks_error_t *results,
+    const goldilocks_ed448_verify_item_s *items,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_NOINLINE;
+
 /**
  * @brief EdDSA point encoding.  Used internally, exposed externally.
  * Multiplies by GOLDILOCKS_448_EDDSA_ENCODE_RATIO first.
@@ -217,6 +464,21 @@ void goldilocks_448_point_mul_by_ratio_and_encode_like_eddsa (
     const goldilocks_448_point_p p
 ) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief EdDSA point encoding of many points at once.  Gives the same
+ * output as goldilocks_448_point_mul_by_ratio_and_encode_like_eddsa on
+ * each point, but shares one field inversion across a block of points.
+ *
+ * @param [out] enc The encoded points, n*GOLDILOCKS_EDDSA_448_PUBLIC_BYTES bytes.
+ * @param [in] points The points.
+ * @param [in] n The number of points.
+ */
+void goldilocks_448_point_mul_by_ratio_and_encode_like_eddsa_batch (
+    uint8_t *enc,
+    const goldilocks_448_point_p *points,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
 /**
  * @brief EdDSA point decoding.  Multiplies by GOLDILOCKS_448_EDDSA_DECODE_RATIO,
  * and ignores cofactor information.
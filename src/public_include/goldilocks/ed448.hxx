@@ -44,10 +44,13 @@ template<> struct EdDSA<Ed448Goldilocks> {
 /** @cond internal */
 template<class CRTP, Prehashed> class Signing;
 template<class CRTP, Prehashed> class Verification;
+template<class Key> class BatchVerification;
 class PublicKeyBase;
 class PrivateKeyBase;
+class PreparedPublicKey;
 typedef class PrivateKeyBase PrivateKey, PrivateKeyPure, PrivateKeyPh;
 typedef class PublicKeyBase PublicKey, PublicKeyPure, PublicKeyPh;
+typedef class BatchVerification<PublicKeyBase> SignatureBatch;
 /** @endcond */
 
 /**
@@ -67,17 +70,14 @@ class Prehash : public SHAKE<256> {
 private:
     /** @cond internal */
     typedef SHAKE<256> Super;
-    SecureBuffer context_;
+    FixedArrayBuffer<255> context_;
+    uint8_t context_len_;
     template<class T, Prehashed Ph> friend class Signing;
     template<class T, Prehashed Ph> friend class Verification;
+    friend class PreparedPublicKey;
 
-    void init() /*throw(LengthException)*/ {
+    void init() GOLDILOCKS_NOEXCEPT {
         Super::reset();
-
-        if (context_.size() > 255) {
-            throw LengthException();
-        }
-
         goldilocks_ed448_prehash_init((goldilocks_shake256_ctx_s *)wrapped);
     }
     /** @endcond */
@@ -88,7 +88,11 @@ public:
 
     /** Create the prehash */
     Prehash(const Block &context = NO_CONTEXT()) /*throw(LengthException)*/ {
-        context_ = context;
+        if (context.size() > 255) {
+            throw LengthException();
+        }
+        if (context.size()) memcpy(context_.data(), context.data(), context.size());
+        context_len_ = context.size();
         init();
     }
 
@@ -126,22 +130,40 @@ public:
         const Block &message,
         const Block &context = NO_CONTEXT()
     ) const /* throw(LengthException, std::bad_alloc) */ {
-        if (context.size() > 255) {
+        SecureBuffer out(CRTP::SIG_BYTES);
+        FixedBuffer<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> sig(out);
+        if (GOLDILOCKS_SUCCESS != sign_noexcept(sig, message, context)) {
             throw LengthException();
         }
+        return out;
+    }
 
-        SecureBuffer out(CRTP::SIG_BYTES);
-        goldilocks_ed448_sign (
+    /**
+     * Sign a message into a buffer, without allocating.
+     * @param [out] out The signature.
+     * @param [in] message The message to be signed.
+     * @param [in] context A context for the signature; must be at most 255 bytes.
+     * @retval GOLDILOCKS_FAILURE The context is too long.
+     */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED sign_noexcept (
+        FixedBuffer<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &out,
+        const Block &message,
+        const Block &context = NO_CONTEXT()
+    ) const GOLDILOCKS_NOEXCEPT {
+        if (context.size() > 255) {
+            return GOLDILOCKS_FAILURE;
+        }
+
+        goldilocks_ed448_sign_expanded (
             out.data(),
-            ((const CRTP*)this)->priv_.data(),
-            ((const CRTP*)this)->pub_.data(),
+            ((const CRTP*)this)->expanded_,
             message.data(),
             message.size(),
             0,
             context.data(),
             context.size()
         );
-        return out;
+        return GOLDILOCKS_SUCCESS;
     }
 };
 
@@ -149,17 +171,31 @@ public:
 template<class CRTP> class Signing<CRTP,PREHASHED> {
 public:
     /** Sign a prehash context, and reset the context */
-    inline SecureBuffer sign_prehashed ( const Prehash &ph ) const /*throw(std::bad_alloc)*/ {
+    inline SecureBuffer sign_prehashed ( const Prehash &ph ) const /*throw(LengthException, std::bad_alloc)*/ {
         SecureBuffer out(CRTP::SIG_BYTES);
-        goldilocks_ed448_sign_prehash (
+        FixedBuffer<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> sig(out);
+        if (GOLDILOCKS_SUCCESS != sign_prehashed_noexcept(sig, ph)) {
+            throw LengthException();
+        }
+        return out;
+    }
+
+    /**
+     * Sign a prehash context into a buffer, without allocating.
+     * @retval GOLDILOCKS_SUCCESS Always, since the Prehash has already checked its context.
+     */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED sign_prehashed_noexcept (
+        FixedBuffer<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &out,
+        const Prehash &ph
+    ) const GOLDILOCKS_NOEXCEPT {
+        goldilocks_ed448_sign_expanded_prehash (
             out.data(),
-            ((const CRTP*)this)->priv_.data(),
-            ((const CRTP*)this)->pub_.data(),
+            ((const CRTP*)this)->expanded_,
             (const goldilocks_ed448_prehash_ctx_s*)ph.wrapped,
             ph.context_.data(),
-            ph.context_.size()
+            ph.context_len_
         );
-        return out;
+        return GOLDILOCKS_SUCCESS;
     }
 
     /** Sign a message using the prehasher */
@@ -171,6 +207,23 @@ public:
         ph += message;
         return sign_prehashed(ph);
     }
+
+    /** Sign a message using the prehasher, into a buffer, without allocating.
+     * @retval GOLDILOCKS_FAILURE The context is too long.
+     */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED sign_with_prehash_noexcept (
+        FixedBuffer<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &out,
+        const Block &message,
+        const Block &context = NO_CONTEXT()
+    ) const GOLDILOCKS_NOEXCEPT {
+        if (context.size() > 255) {
+            return GOLDILOCKS_FAILURE;
+        }
+
+        Prehash ph(context);
+        ph += message;
+        return sign_prehashed_noexcept(out, ph);
+    }
 };
 
 /** Signing (i.e. private) key base class */
@@ -191,8 +244,8 @@ private:
     /** The pre-expansion form of the signing key. */
     FixedArrayBuffer<GOLDILOCKS_EDDSA_448_PRIVATE_BYTES> priv_;
 
-    /** The post-expansion public key. */
-    FixedArrayBuffer<GOLDILOCKS_EDDSA_448_PUBLIC_BYTES> pub_;
+    /** The post-expansion form: secret scalar, nonce seed and public key. */
+    goldilocks_ed448_expanded_key_p expanded_;
 
 public:
     /** Underlying group */
@@ -206,7 +259,7 @@ public:
 
 
     /** Create but don't initialize */
-    inline explicit PrivateKeyBase(const NOINIT&) GOLDILOCKS_NOEXCEPT : priv_((NOINIT())), pub_((NOINIT())) { }
+    inline explicit PrivateKeyBase(const NOINIT&) GOLDILOCKS_NOEXCEPT : priv_((NOINIT())) { }
 
     /** Read a private key from a string */
     inline explicit PrivateKeyBase(const FixedBlock<SER_BYTES> &b) GOLDILOCKS_NOEXCEPT { *this = b; }
@@ -216,20 +269,25 @@ public:
 
     /** Create at random */
     inline explicit PrivateKeyBase(Rng &r) GOLDILOCKS_NOEXCEPT : priv_(r) {
-        goldilocks_ed448_derive_public_key(pub_.data(), priv_.data());
+        goldilocks_ed448_expand_private_key(expanded_, priv_.data());
+    }
+
+    /** Destructor securely zeroizes the expanded key. */
+    inline ~PrivateKeyBase() GOLDILOCKS_NOEXCEPT {
+        goldilocks_ed448_expanded_key_destroy(expanded_);
     }
 
     /** Assignment from string */
     inline PrivateKeyBase &operator=(const FixedBlock<SER_BYTES> &b) GOLDILOCKS_NOEXCEPT {
         memcpy(priv_.data(),b.data(),b.size());
-        goldilocks_ed448_derive_public_key(pub_.data(), priv_.data());
+        goldilocks_ed448_expand_private_key(expanded_, priv_.data());
         return *this;
     }
 
     /** Copy assignment */
     inline PrivateKeyBase &operator=(const PrivateKey &k) GOLDILOCKS_NOEXCEPT {
         memcpy(priv_.data(),k.priv_.data(), priv_.size());
-        memcpy(pub_.data(),k.pub_.data(), pub_.size());
+        memcpy(expanded_,k.expanded_,sizeof(expanded_));
         return *this;
     }
 
@@ -298,6 +356,117 @@ public:
             throw CryptoException();
         }
     }
+
+    /** Verify a signature by re-encoding R, returning GOLDILOCKS_FAILURE if verification fails.
+     * Stricter than verify_noexcept: see goldilocks_ed448_verify_strict. */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED verify_strict_noexcept (
+        const FixedBlock<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &sig,
+        const Block &message,
+        const Block &context = NO_CONTEXT()
+    ) const /*GOLDILOCKS_NOEXCEPT*/ {
+        if (context.size() > 255) {
+            return GOLDILOCKS_FAILURE;
+        }
+
+        return goldilocks_ed448_verify_strict (
+            sig.data(),
+            ((const CRTP*)this)->pub_.data(),
+            message.data(),
+            message.size(),
+            0,
+            context.data(),
+            context.size()
+        );
+    }
+
+    /** Verify a signature by re-encoding R, throwing an exception if verification fails.
+     * Stricter than verify: see goldilocks_ed448_verify_strict. */
+    inline void verify_strict (
+        const FixedBlock<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &sig,
+        const Block &message,
+        const Block &context = NO_CONTEXT()
+    ) const /*throw(LengthException,CryptoException)*/ {
+        if (context.size() > 255) {
+            throw LengthException();
+        }
+
+        if (GOLDILOCKS_SUCCESS != verify_strict_noexcept( sig, message, context )) {
+            throw CryptoException();
+        }
+    }
+};
+
+/**
+ * A batch of EdDSA signatures, checked all at once with goldilocks_ed448_verify_batch.
+ * The batch only refers to the keys, signatures, messages and contexts added to it,
+ * so they must stay alive until it has been verified.
+ */
+template<class Key> class BatchVerification {
+private:
+/** @cond internal */
+    std::vector<goldilocks_ed448_verify_item_s> items_;
+    inline const goldilocks_ed448_verify_item_s *items() const GOLDILOCKS_NOEXCEPT {
+        return items_.empty() ? NULL : &items_[0];
+    }
+/** @endcond */
+
+public:
+    /** Add a signature to the batch.
+     * @param [in] pub The public key.
+     * @param [in] sig The signature.
+     * @param [in] message The signed message.
+     * @param [in] context A context for the signature; must be at most 255 bytes.
+     */
+    inline void add (
+        const Key &pub,
+        const FixedBlock<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &sig,
+        const Block &message,
+        const Block &context = NO_CONTEXT()
+    ) /*throw(LengthException,std::bad_alloc)*/ {
+        if (context.size() > 255) {
+            throw LengthException();
+        }
+
+        goldilocks_ed448_verify_item_s item;
+        item.signature = sig.data();
+        item.pubkey = pub.pub_.data();
+        item.message = message.data();
+        item.message_len = message.size();
+        item.prehashed = 0;
+        item.context = context.data();
+        item.context_len = context.size();
+        items_.push_back(item);
+    }
+
+    /** Number of signatures in the batch. */
+    inline size_t size() const GOLDILOCKS_NOEXCEPT { return items_.size(); }
+
+    /** Remove all signatures from the batch. */
+    inline void clear() GOLDILOCKS_NOEXCEPT { items_.clear(); }
+
+    /** Verify the batch, returning GOLDILOCKS_FAILURE if any signature is invalid */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED verify_noexcept() const GOLDILOCKS_NOEXCEPT {
+        return goldilocks_ed448_verify_batch(NULL, items(), items_.size());
+    }
+
+    /** Verify the batch, also reporting which signatures are invalid.
+     * @param [out] results The result for each signature, in the order they were added.
+     */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED verify_noexcept (
+        std::vector<goldilocks_error_t> &results
+    ) const /*throw(std::bad_alloc)*/ {
+        results.resize(items_.size());
+        return goldilocks_ed448_verify_batch(
+            results.empty() ? NULL : &results[0], items(), items_.size()
+        );
+    }
+
+    /** Verify the batch, throwing an exception if any signature is invalid */
+    inline void verify() const /*throw(CryptoException)*/ {
+        if (GOLDILOCKS_SUCCESS != verify_noexcept()) {
+            throw CryptoException();
+        }
+    }
 };
 
 /** Verification (i.e. public) EdDSA key, prehashed version. */
@@ -313,7 +482,7 @@ public:
             ((const CRTP*)this)->pub_.data(),
             (const goldilocks_ed448_prehash_ctx_s*)ph.wrapped,
             ph.context_.data(),
-            ph.context_.size()
+            ph.context_len_
         );
     }
 
@@ -327,7 +496,7 @@ public:
             ((const CRTP*)this)->pub_.data(),
             (const goldilocks_ed448_prehash_ctx_s*)ph.wrapped,
             ph.context_.data(),
-            ph.context_.size()
+            ph.context_len_
         )) {
             throw CryptoException();
         }
@@ -343,6 +512,30 @@ public:
         ph += message;
         verify_prehashed(sig,ph);
     }
+
+    /** Verify a prehashed message by re-encoding R.  See goldilocks_ed448_verify_strict. */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED verify_strict_prehashed_noexcept (
+        const FixedBlock<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &sig,
+        const Prehash &ph
+    ) const /*GOLDILOCKS_NOEXCEPT*/ {
+        return goldilocks_ed448_verify_strict_prehash (
+            sig.data(),
+            ((const CRTP*)this)->pub_.data(),
+            (const goldilocks_ed448_prehash_ctx_s*)ph.wrapped,
+            ph.context_.data(),
+            ph.context_len_
+        );
+    }
+
+    /** Verify a prehashed message by re-encoding R.  See goldilocks_ed448_verify_strict. */
+    inline void verify_strict_prehashed (
+        const FixedBlock<GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES> &sig,
+        const Prehash &ph
+    ) const /*throw(CryptoException)*/ {
+        if (GOLDILOCKS_SUCCESS != verify_strict_prehashed_noexcept(sig,ph)) {
+            throw CryptoException();
+        }
+    }
 };
 
 /** EdDSA Public key base class. */
@@ -357,8 +550,10 @@ public:
 private:
 /** @cond internal */
     friend class PrivateKeyBase;
+    friend class PreparedPublicKey;
     friend class Verification<PublicKey,PURE>;
     friend class Verification<PublicKey,PREHASHED>;
+    friend class BatchVerification<PublicKey>;
 
 private:
     /** The pre-expansion form of the signature */
@@ -366,8 +561,6 @@ private:
 /** @endcond */
 
 public:
-    /* PERF FUTURE: Pre-cached decoding? Precomputed table?? */
-
     /** Underlying group */
     typedef Ed448Goldilocks Group;
 
@@ -402,7 +595,8 @@ public:
 
     /** Assignment from private key */
     inline PublicKey &operator=(const PrivateKey &p) GOLDILOCKS_NOEXCEPT {
-        return *this = p.pub_;
+        memcpy(pub_.data(),p.expanded_->pubkey,pub_.size());
+        return *this;
     }
 
     /** Serialization size. */
@@ -421,6 +615,88 @@ public:
     }
 }; /* class PublicKey */
 
+/**
+ * A public key which has been decoded, with a table of its multiples,
+ * for verifying many signatures by the same signer.  Large (about 6 KiB).
+ */
+class PreparedPublicKey {
+private:
+/** @cond internal */
+    goldilocks_ed448_prepared_public_key_p prepared_;
+/** @endcond */
+
+public:
+    /** Signature size. */
+    static const size_t SIG_BYTES = GOLDILOCKS_EDDSA_448_SIGNATURE_BYTES;
+
+    /** Prepare a public key; throws CryptoException if it doesn't decode */
+    inline explicit PreparedPublicKey(const PublicKey &pub) /*throw(CryptoException)*/ {
+        if (GOLDILOCKS_SUCCESS != goldilocks_ed448_prepare_public_key(prepared_, pub.pub_.data())) {
+            throw CryptoException();
+        }
+    }
+
+    /** Verify a signature, returning GOLDILOCKS_FAILURE if verification fails */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED verify_noexcept (
+        const FixedBlock<SIG_BYTES> &sig,
+        const Block &message,
+        const Block &context = NO_CONTEXT()
+    ) const /*GOLDILOCKS_NOEXCEPT*/ {
+        if (context.size() > 255) {
+            return GOLDILOCKS_FAILURE;
+        }
+
+        return goldilocks_ed448_verify_prepared (
+            sig.data(),
+            prepared_,
+            message.data(),
+            message.size(),
+            0,
+            context.data(),
+            context.size()
+        );
+    }
+
+    /** Verify a signature, throwing an exception if verification fails */
+    inline void verify (
+        const FixedBlock<SIG_BYTES> &sig,
+        const Block &message,
+        const Block &context = NO_CONTEXT()
+    ) const /*throw(LengthException,CryptoException)*/ {
+        if (context.size() > 255) {
+            throw LengthException();
+        }
+
+        if (GOLDILOCKS_SUCCESS != verify_noexcept( sig, message, context )) {
+            throw CryptoException();
+        }
+    }
+
+    /** Verify that a signature is valid for a given prehashed message, given the context. */
+    inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED verify_prehashed_noexcept (
+        const FixedBlock<SIG_BYTES> &sig,
+        const Prehash &ph
+    ) const /*GOLDILOCKS_NOEXCEPT*/ {
+        return goldilocks_ed448_verify_prepared_prehash (
+            sig.data(),
+            prepared_,
+            (const goldilocks_ed448_prehash_ctx_s*)ph.wrapped,
+            ph.context_.data(),
+            ph.context_len_
+        );
+    }
+
+    /** Verify that a signature is valid for a given prehashed message, given the context. */
+    inline void verify_prehashed (
+        const FixedBlock<SIG_BYTES> &sig,
+        const Prehash &ph
+    ) const /*throw(CryptoException)*/ {
+        if (GOLDILOCKS_SUCCESS != verify_prehashed_noexcept(sig,ph)) {
+            throw CryptoException();
+        }
+    }
+}; /* class PreparedPublicKey */
+
 }; /* template<> struct EdDSA<Ed448Goldilocks> */
 
 #undef GOLDILOCKS_NOEXCEPT
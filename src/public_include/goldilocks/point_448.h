@@ -78,6 +78,36 @@ typedef struct goldilocks_448_precomputed_s goldilocks_448_precomputed_s;
 /** Size and alignment of precomputed point tables. */
 extern const size_t goldilocks_448_sizeof_precomputed_s GOLDILOCKS_API_VIS, goldilocks_448_alignof_precomputed_s GOLDILOCKS_API_VIS;
 
+/**
+ * Precomputed comb table with a caller-chosen geometry, for trading table
+ * size against point additions.  Allocate goldilocks_448_sizeof_precomputed_comb
+ * bytes, aligned to goldilocks_448_alignof_precomputed_s.
+ */
+typedef struct goldilocks_448_precomputed_comb_s goldilocks_448_precomputed_comb_s;
+
+/**
+ * An X448 peer public key with a precomputed table, for computing many
+ * shared secrets with the same peer.  Allocate goldilocks_x448_sizeof_prepared_peer
+ * bytes, aligned to goldilocks_x448_alignof_prepared_peer.
+ */
+typedef struct goldilocks_x448_prepared_peer_s goldilocks_x448_prepared_peer_s;
+
+/** Size and alignment of prepared X448 peers. */
+extern const size_t goldilocks_x448_sizeof_prepared_peer GOLDILOCKS_API_VIS, goldilocks_x448_alignof_prepared_peer GOLDILOCKS_API_VIS;
+
+/** Window size of the tables made by goldilocks_448_precompute_wnaf. */
+#define GOLDILOCKS_448_WNAF_TABLE_BITS 5
+
+/**
+ * Precomputed wNAF table of the odd multiples P, 3P, ..., of a point,
+ * for repeated variable-time scalar multiplication by that point.
+ */
+typedef struct goldilocks_448_precomputed_wnaf_s {
+    /** @cond internal */
+    gf_448_p table[3<<GOLDILOCKS_448_WNAF_TABLE_BITS]; /* Affine Niels form */
+    /** @endcond */
+} goldilocks_448_precomputed_wnaf_s, goldilocks_448_precomputed_wnaf_p[1];
+
 /** Representation of an element of the scalar field. */
 typedef struct goldilocks_448_scalar_s {
     /** @cond internal */
@@ -209,6 +239,23 @@ goldilocks_error_t goldilocks_448_scalar_invert (
     const goldilocks_448_scalar_p a
 ) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief Invert many scalars at once, with Montgomery's trick.  This costs
+ * one inversion plus three multiplications per scalar.  As with
+ * goldilocks_448_scalar_invert, zero inputs give zero outputs; which
+ * inputs were zero doesn't affect the timing.
+ *
+ * @param [out] out The inverses 1/in[i].  Must not overlap in.
+ * @param [in] in The scalars to invert.
+ * @param [in] n The number of scalars.
+ * @return GOLDILOCKS_SUCCESS All the inputs are nonzero.
+ */
+goldilocks_error_t goldilocks_448_scalar_batch_invert (
+    goldilocks_448_scalar_p *__restrict__ out,
+    const goldilocks_448_scalar_p *in,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
 /**
  * @brief Copy a scalar.  The scalars may use the same memory, in which
  * case this function does nothing.
@@ -263,6 +310,42 @@ goldilocks_error_t goldilocks_448_point_decode (
     goldilocks_bool_t allow_identity
 ) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief Encode many points at once.  Gives the same output as
+ * goldilocks_448_point_encode on each point, but computes the inverse
+ * square roots several at a time.
+ *
+ * @param [out] ser The encoded points, n*GOLDILOCKS_448_SER_BYTES bytes.
+ * @param [in] points The points to encode.
+ * @param [in] n The number of points.
+ */
+void goldilocks_448_point_encode_batch (
+    uint8_t *ser,
+    const goldilocks_448_point_p *points,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Decode many points at once.  Each point is decoded as by
+ * goldilocks_448_point_decode, but the inverse square roots are
+ * computed several at a time.
+ *
+ * @param [out] points The decoded points.
+ * @param [out] results If not NULL, the result of decoding each point.
+ * @param [in] ser The serialized points, n*GOLDILOCKS_448_SER_BYTES bytes.
+ * @param [in] n The number of points.
+ * @param [in] allow_identity GOLDILOCKS_TRUE if the identity is a legal input.
+ * @retval GOLDILOCKS_SUCCESS Every point was decoded.
+ * @retval GOLDILOCKS_FAILURE At least one point didn't decode.
+ */
+goldilocks_error_t goldilocks_448_point_decode_batch (
+    goldilocks_448_point_p *points,
+    goldilocks_error_t *results,
+    const uint8_t *ser,
+    size_t n,
+    goldilocks_bool_t allow_identity
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED __attribute__((nonnull(1,3))) GOLDILOCKS_NOINLINE;
+
 /**
  * @brief Copy a point.  The input and output may alias,
  * in which case this function does nothing.
@@ -401,6 +484,30 @@ goldilocks_error_t goldilocks_x448 (
     const uint8_t scalar[GOLDILOCKS_X448_PRIVATE_BYTES]
 ) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_WARN_UNUSED GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief RFC 7748 Diffie-Hellman on many public keys and scalars at once.
+ * Gives the same output as goldilocks_x448 on each pair, but runs several
+ * ladders side by side in vector lanes where the CPU allows, and shares
+ * one field inversion across a block of them.
+ *
+ * @param [out] shared The shared secrets, n*GOLDILOCKS_X448_PUBLIC_BYTES bytes.
+ * @param [out] results If non-NULL, whether each scalarmul succeeded.
+ * @param [in] base The other parties' public keys, n*GOLDILOCKS_X448_PUBLIC_BYTES bytes.
+ * @param [in] scalar The private scalars, n*GOLDILOCKS_X448_PRIVATE_BYTES bytes.
+ * @param [in] n The number of scalarmuls.
+ *
+ * @retval GOLDILOCKS_SUCCESS Every scalarmul succeeded.
+ * @retval GOLDILOCKS_FAILURE Some scalarmul didn't succeed, because its base
+ * point is in a small subgroup.
+ */
+goldilocks_error_t goldilocks_x448_batch (
+    uint8_t *shared,
+    goldilocks_error_t *results,
+    const uint8_t *base,
+    const uint8_t *scalar,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED __attribute__((nonnull(1,3,4))) GOLDILOCKS_NOINLINE;
+
 /**
  * @brief Multiply a point by GOLDILOCKS_X448_ENCODE_RATIO,
  * then encode it like RFC 7748.
@@ -426,6 +533,21 @@ void goldilocks_448_point_mul_by_ratio_and_encode_like_x448 (
     const goldilocks_448_point_p p
 ) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL;
 
+/**
+ * @brief RFC 7748 encoding of many points at once.  Gives the same output
+ * as goldilocks_448_point_mul_by_ratio_and_encode_like_x448 on each point,
+ * but shares one field inversion across a block of points.
+ *
+ * @param [out] out The scaled and encoded points, n*GOLDILOCKS_X448_PUBLIC_BYTES bytes.
+ * @param [in] points The points to be scaled and encoded.
+ * @param [in] n The number of points.
+ */
+void goldilocks_448_point_mul_by_ratio_and_encode_like_x448_batch (
+    uint8_t *out,
+    const goldilocks_448_point_p *points,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL;
+
 /** The base point for X448 Diffie-Hellman */
 extern const uint8_t
     goldilocks_x448_base_point[GOLDILOCKS_X448_PUBLIC_BYTES]
@@ -447,6 +569,62 @@ void goldilocks_x448_derive_public_key (
     const uint8_t scalar[GOLDILOCKS_X448_PRIVATE_BYTES]
 ) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief RFC 7748 Diffie-Hellman public keys for many private scalars.
+ * Gives the same output as goldilocks_x448_derive_public_key on each,
+ * but shares one field inversion across a block of them.
+ *
+ * @param [out] out The public keys, n*GOLDILOCKS_X448_PUBLIC_BYTES bytes.
+ * @param [in] scalar The private scalars, n*GOLDILOCKS_X448_PRIVATE_BYTES bytes.
+ * @param [in] n The number of keys.
+ */
+void goldilocks_x448_derive_public_key_batch (
+    uint8_t *out,
+    const uint8_t *scalar,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Prepare an X448 peer public key for goldilocks_x448_shared_secret_prepared,
+ * by finding an Edwards point with its u-coordinate and precomputing a table
+ * of its multiples.  Public keys that are not on the curve are kept as they
+ * are, and their shared secrets fall back to the Montgomery ladder.
+ *
+ * @param [out] prepared The prepared peer.
+ * @param [in] peer The other party's public key.
+ */
+void goldilocks_x448_prepare_peer (
+    goldilocks_x448_prepared_peer_s *prepared,
+    const uint8_t peer[GOLDILOCKS_X448_PUBLIC_BYTES]
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief RFC 7748 Diffie-Hellman with a prepared peer.  Gives the same output
+ * as goldilocks_x448 on the peer's public key, using a constant-time table
+ * lookup in place of the ladder.
+ *
+ * @param [out] shared The shared secret peer*scalar
+ * @param [in] prepared The other party's prepared public key.
+ * @param [in] scalar The private scalar to multiply by.
+ *
+ * @retval GOLDILOCKS_SUCCESS The scalarmul succeeded.
+ * @retval GOLDILOCKS_FAILURE The scalarmul didn't succeed, because the base
+ * point is in a small subgroup.
+ */
+goldilocks_error_t goldilocks_x448_shared_secret_prepared (
+    uint8_t shared[GOLDILOCKS_X448_PUBLIC_BYTES],
+    const goldilocks_x448_prepared_peer_s *prepared,
+    const uint8_t scalar[GOLDILOCKS_X448_PRIVATE_BYTES]
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_WARN_UNUSED GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Overwrite a prepared X448 peer with zeros.
+ * @param [in] prepared The prepared peer.
+ */
+void goldilocks_x448_prepared_peer_destroy (
+    goldilocks_x448_prepared_peer_s *prepared
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL;
+
 /* FUTURE: uint8_t goldilocks_448_encode_like_curve448) */
 
 /**
@@ -480,6 +658,59 @@ void goldilocks_448_precomputed_scalarmul (
     const goldilocks_448_scalar_p scalar
 ) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief Size of a comb table with n combs of t teeth, spaced s bits apart.
+ * The table holds n*2^(t-1) points.  Each scalar multiplication costs n*s
+ * table lookups and additions, and s-1 doublings.
+ *
+ * @param [in] n The number of combs, at least 1.
+ * @param [in] t The number of teeth per comb, from 2 to 10.
+ * @param [in] s The spacing of the teeth, at most GOLDILOCKS_448_SCALAR_BITS.
+ * n*t*s must be at least GOLDILOCKS_448_SCALAR_BITS.
+ *
+ * @return The size in bytes, or 0 if the geometry is not supported.  Tables
+ * of more than 512 points are not supported.
+ */
+size_t goldilocks_448_sizeof_precomputed_comb (
+    unsigned int n,
+    unsigned int t,
+    unsigned int s
+) GOLDILOCKS_API_VIS GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Precompute a comb table of the given geometry for a point.
+ *
+ * @param [out] table The table, of goldilocks_448_sizeof_precomputed_comb(n,t,s) bytes.
+ * @param [in] base Any point.
+ * @param [in] n The number of combs.
+ * @param [in] t The number of teeth per comb.
+ * @param [in] s The spacing of the teeth.
+ *
+ * @retval GOLDILOCKS_SUCCESS The table was built.
+ * @retval GOLDILOCKS_FAILURE The geometry is not supported.
+ */
+goldilocks_error_t goldilocks_448_precompute_comb (
+    goldilocks_448_precomputed_comb_s *table,
+    const goldilocks_448_point_p base,
+    unsigned int n,
+    unsigned int t,
+    unsigned int s
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Multiply a point by a scalar using its comb table:
+ * scaled = scalar*base.  Constant time.
+ *
+ * @param [out] scaled The scaled point base*scalar
+ * @param [in] table The table made by goldilocks_448_precompute_comb.
+ * @param [in] scalar The scalar to multiply by.
+ */
+void goldilocks_448_precomputed_comb_scalarmul (
+    goldilocks_448_point_p scaled,
+    const goldilocks_448_precomputed_comb_s *table,
+    const goldilocks_448_scalar_p scalar
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
 /**
  * @brief Multiply two base points by two scalars:
  * scaled = scalar1*base1 + scalar2*base2.
@@ -546,6 +777,62 @@ void goldilocks_448_base_double_scalarmul_non_secret (
     const goldilocks_448_scalar_p scalar2
 ) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
 
+/**
+ * @brief Precompute a wNAF table for goldilocks_448_base_double_scalarmul_precomputed_non_secret.
+ *
+ * @param [out] table The table of multiples of the point.
+ * @param [in] base Any point.
+ */
+void goldilocks_448_precompute_wnaf (
+    goldilocks_448_precomputed_wnaf_p table,
+    const goldilocks_448_point_p base
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Same as goldilocks_448_base_double_scalarmul_non_secret, but with the
+ * second point given as a precomputed wNAF table.  This skips building a
+ * table on each call, and its wider window needs fewer additions.
+ *
+ * @param [out] combo The linear combination scalar1*base + scalar2*base2.
+ * @param [in] scalar1 A first scalar to multiply by.
+ * @param [in] base2 A table made by goldilocks_448_precompute_wnaf.
+ * @param [in] scalar2 A second scalar to multiply by.
+ *
+ * @warning: This function takes variable time, and may leak the scalars
+ * used.  It is designed for signature verification.
+ */
+void goldilocks_448_base_double_scalarmul_precomputed_non_secret (
+    goldilocks_448_point_p combo,
+    const goldilocks_448_scalar_p scalar1,
+    const goldilocks_448_precomputed_wnaf_p base2,
+    const goldilocks_448_scalar_p scalar2
+) GOLDILOCKS_API_VIS GOLDILOCKS_NONNULL GOLDILOCKS_NOINLINE;
+
+/**
+ * @brief Multiply many points by many scalars and add the results:
+ * out = sum scalars[i]*points[i].
+ *
+ * Uses interleaved wNAFs (Straus) for small n, and Pippenger's bucket
+ * method with a window chosen from n for large n.
+ *
+ * @param [out] out The linear combination.
+ * @param [in] points The points to be scaled.
+ * @param [in] scalars The scalars to multiply by, one per point.
+ * @param [in] n The number of points and scalars.
+ *
+ * @retval GOLDILOCKS_SUCCESS The combination was computed.
+ * @retval GOLDILOCKS_FAILURE Working memory could not be allocated.
+ *
+ * @warning: This function takes variable time, and may leak the scalars
+ * used.  It is designed for batch signature verification.
+ */
+goldilocks_error_t goldilocks_448_point_multiscalarmul_non_secret (
+    goldilocks_448_point_p out,
+    const goldilocks_448_point_p *points,
+    const goldilocks_448_scalar_p *scalars,
+    size_t n
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED __attribute__((nonnull(1))) GOLDILOCKS_NOINLINE;
+
 /**
  * @brief Constant-time decision between two points.  If pick_b
  * is zero, out = a; else out = b.
@@ -742,6 +1029,13 @@ void goldilocks_448_precomputed_destroy (
     goldilocks_448_precomputed_s *pre
 ) GOLDILOCKS_NONNULL GOLDILOCKS_API_VIS;
 
+/** Securely erase a comb table by overwriting it with zeros.
+ * @warning This causes the table object to become invalid.
+ */
+void goldilocks_448_precomputed_comb_destroy (
+    goldilocks_448_precomputed_comb_s *table
+) GOLDILOCKS_NONNULL GOLDILOCKS_API_VIS;
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
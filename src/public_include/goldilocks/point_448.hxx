@@ -202,6 +202,34 @@ public:
         return goldilocks_448_scalar_invert(r.s,s);
     }
 
+    /** Invert many scalars with one inversion.  Zero scalars are inverted to zero.
+     * @return GOLDILOCKS_FAILURE if any of them was zero. */
+    static inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED batch_inverse_noexcept (
+        std::vector<Scalar> &out, const std::vector<Scalar> &in
+    ) /*throw(std::bad_alloc)*/ {
+        const size_t n = in.size();
+        std::vector<goldilocks_448_scalar_s> ia(n), oa(n);
+        for (size_t i=0; i<n; i++) ia[i] = in[i].s[0];
+        goldilocks_error_t ret = goldilocks_448_scalar_batch_invert(
+            (goldilocks_448_scalar_p *)oa.data(), (const goldilocks_448_scalar_p *)ia.data(), n
+        );
+        out.resize(n);
+        for (size_t i=0; i<n; i++) {
+            out[i].s[0] = oa[i];
+            goldilocks_448_scalar_destroy(&ia[i]);
+            goldilocks_448_scalar_destroy(&oa[i]);
+        }
+        return ret;
+    }
+
+    /** Invert many scalars with one inversion.  @throw CryptoException if any of them is zero. */
+    static inline std::vector<Scalar> batch_inverse(const std::vector<Scalar> &in)
+    /*throw(CryptoException,std::bad_alloc)*/ {
+        std::vector<Scalar> out;
+        if (GOLDILOCKS_SUCCESS != batch_inverse_noexcept(out,in)) throw CryptoException();
+        return out;
+    }
+
     /** Return this/q. @throw CryptoException if q == 0. */
     inline Scalar operator/ (const Scalar &q) const /*throw(CryptoException)*/ { return *this * q.inverse(); }
 
@@ -508,6 +536,42 @@ public:
         Point r((NOINIT())); goldilocks_448_base_double_scalarmul_non_secret(r.p,s_base.s,p,s.s); return r;
     }
 
+    /**
+     * Multi-scalar multiply, equivalent to the sum of points[i]*scalars[i] but faster.
+     * @warning This function takes variable time, and may leak the scalars (or points, but currently
+     * it doesn't).
+     * @throw LengthException if there isn't one scalar per point.
+     * @throw std::bad_alloc if working memory could not be allocated.
+     */
+    static inline Point multiscalarmul_non_secret (
+        const std::vector<Point> &points, const std::vector<Scalar> &scalars
+    ) /*throw(LengthException,std::bad_alloc)*/ {
+        const size_t n = points.size();
+        if (scalars.size() != n) throw LengthException();
+
+        void *ps = NULL, *ss = NULL;
+        if (n && (posix_memalign(&ps, sizeof(goldilocks_448_point_p), n*sizeof(goldilocks_448_point_p))
+            || posix_memalign(&ss, sizeof(goldilocks_448_point_p), n*sizeof(goldilocks_448_scalar_p)))) {
+            free(ps);
+            throw std::bad_alloc();
+        }
+        goldilocks_448_point_p *pa = (goldilocks_448_point_p *)ps;
+        goldilocks_448_scalar_p *sa = (goldilocks_448_scalar_p *)ss;
+        for (size_t i=0; i<n; i++) {
+            goldilocks_448_point_copy(pa[i], points[i].p);
+            goldilocks_448_scalar_copy(sa[i], scalars[i].s);
+        }
+
+        Point r((NOINIT()));
+        goldilocks_error_t ret = goldilocks_448_point_multiscalarmul_non_secret(
+            r.p, (const goldilocks_448_point_p *)pa, (const goldilocks_448_scalar_p *)sa, n
+        );
+        free(ps);
+        free(ss);
+        if (ret != GOLDILOCKS_SUCCESS) throw std::bad_alloc();
+        return r;
+    }
+
     /** Return a point equal to *this, whose internal data is rotated by a torsion element. */
     inline Point debugging_torque() const GOLDILOCKS_NOEXCEPT {
         Point q;
@@ -695,6 +759,17 @@ public:
         return out;
     }
 
+    /** Calculate and write into out a shared secret with public key, without allocating.  */
+    static inline void shared_secret(
+        FixedBuffer<PUBLIC_BYTES> &out,
+        const FixedBlock<PUBLIC_BYTES> &pk,
+        const FixedBlock<PRIVATE_BYTES> &scalar
+    ) /*throw(CryptoException)*/ {
+        if (GOLDILOCKS_SUCCESS != goldilocks_x448(out.data(), pk.data(), scalar.data())) {
+            throw CryptoException();
+        }
+    }
+
     /** Calculate and write into out a shared secret with public key, noexcept version.  */
     static inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED
     shared_secret_noexcept (
@@ -726,6 +801,67 @@ public:
     ) GOLDILOCKS_NOEXCEPT {
         goldilocks_x448_derive_public_key(out.data(), scalar.data());
     }
+
+    /**
+     * A peer's public key with a precomputed table, for computing many
+     * shared secrets with the same peer faster than with the ladder.
+     */
+    class PreparedPeer {
+    private:
+        goldilocks_x448_prepared_peer_s *prepared;
+
+        /* Noncopyable */
+        PreparedPeer(const PreparedPeer &);
+        PreparedPeer &operator=(const PreparedPeer &);
+
+    public:
+        /** Prepare a public key. */
+        inline explicit PreparedPeer(
+            const FixedBlock<PUBLIC_BYTES> &pk
+        ) /*throw(std::bad_alloc)*/ {
+            if (posix_memalign((void**)&prepared, goldilocks_x448_alignof_prepared_peer,
+                goldilocks_x448_sizeof_prepared_peer) || !prepared) {
+                throw std::bad_alloc();
+            }
+            goldilocks_x448_prepare_peer(prepared, pk.data());
+        }
+
+        /** Destructor securely zeorizes the table. */
+        inline ~PreparedPeer() GOLDILOCKS_NOEXCEPT {
+            goldilocks_x448_prepared_peer_destroy(prepared);
+            free(prepared);
+        }
+
+        /** Calculate and return the shared secret; equivalent to shared_secret(pk,scalar). */
+        inline SecureBuffer shared_secret(
+            const FixedBlock<PRIVATE_BYTES> &scalar
+        ) const /*throw(std::bad_alloc,CryptoException)*/ {
+            SecureBuffer out(PUBLIC_BYTES);
+            if (GOLDILOCKS_SUCCESS != goldilocks_x448_shared_secret_prepared(out.data(), prepared, scalar.data())) {
+                throw CryptoException();
+            }
+            return out;
+        }
+
+        /** Calculate and write into out the shared secret, without allocating. */
+        inline void shared_secret(
+            FixedBuffer<PUBLIC_BYTES> &out,
+            const FixedBlock<PRIVATE_BYTES> &scalar
+        ) const /*throw(CryptoException)*/ {
+            if (GOLDILOCKS_SUCCESS != goldilocks_x448_shared_secret_prepared(out.data(), prepared, scalar.data())) {
+                throw CryptoException();
+            }
+        }
+
+        /** Calculate and write into out the shared secret, noexcept version. */
+        inline goldilocks_error_t GOLDILOCKS_WARN_UNUSED
+        shared_secret_noexcept (
+            FixedBuffer<PUBLIC_BYTES> &out,
+            const FixedBlock<PRIVATE_BYTES> &scalar
+        ) const GOLDILOCKS_NOEXCEPT {
+            return goldilocks_x448_shared_secret_prepared(out.data(), prepared, scalar.data());
+        }
+    };
 };
 
 }; /* struct Ed448Goldilocks */
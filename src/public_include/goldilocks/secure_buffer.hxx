@@ -37,7 +37,10 @@ namespace goldilocks {
 */
 static inline void really_bzero(void *data, size_t size) { goldilocks_bzero(data,size); }
 
-/** @brief An allocator which zeros its memory on free */
+/**
+ * @brief An allocator which zeros its memory on free.  Unaligned allocations
+ * come from the locked pool if goldilocks_secure_pool_enable has been called.
+ */
 template<typename T, size_t alignment = 0> class SanitizingAllocator {
 /** @cond internal */
 /* Based on http://www.codeproject.com/Articles/4795/C-Standard-Allocator-An-Introduction-and-Implement */
@@ -469,7 +472,7 @@ T* SanitizingAllocator<T,alignment>::allocate (
     int ret = 0;
  
     if (alignment) ret = posix_memalign(&v, alignment, cnt * sizeof(T));
-    else v = malloc(cnt * sizeof(T));
+    else v = goldilocks_secure_malloc(cnt * sizeof(T));
  
     if (ret || v==NULL) throw(std::bad_alloc());
     return reinterpret_cast<T*>(v);
@@ -478,8 +481,12 @@ T* SanitizingAllocator<T,alignment>::allocate (
 template<typename T, size_t alignment>
 void SanitizingAllocator<T,alignment>::deallocate(T* p, size_t size) GOLDILOCKS_NOEXCEPT {
     if (p==NULL) return;
-    really_bzero(reinterpret_cast<void*>(p), size);
-    free(reinterpret_cast<void*>(p));
+    if (alignment) {
+        really_bzero(reinterpret_cast<void*>(p), size * sizeof(T));
+        free(reinterpret_cast<void*>(p));
+    } else {
+        goldilocks_secure_free(reinterpret_cast<void*>(p), size * sizeof(T));
+    }
 }
 
 /** @endcond */
@@ -147,6 +147,108 @@ goldilocks_error_t goldilocks_sha3_hash (
     const struct goldilocks_kparams_s *params
 ) GOLDILOCKS_API_VIS;
 
+/**
+ * @brief Hash four inputs of the same length at once, as if by
+ * goldilocks_sha3_hash on each.  This runs four permutations side by
+ * side, using AVX2 where the CPU has it.
+ * @param [out] out Four buffers for the output data.
+ * @param [in] outlen The length of each output.
+ * @param [in] in The four inputs.
+ * @param [in] inlen The length of each input.
+ * @param [in] params The parameters of the sponge hash.
+ */
+goldilocks_error_t goldilocks_sha3_hash_x4 (
+    uint8_t *const out[4],
+    size_t outlen,
+    const uint8_t *const in[4],
+    size_t inlen,
+    const struct goldilocks_kparams_s *params
+) GOLDILOCKS_API_VIS;
+
+/**
+ * @brief Hash eight inputs of the same length at once, as if by
+ * goldilocks_sha3_hash on each.  This runs eight permutations side by
+ * side, using AVX-512 where the CPU has it.
+ * @param [out] out Eight buffers for the output data.
+ * @param [in] outlen The length of each output.
+ * @param [in] in The eight inputs.
+ * @param [in] inlen The length of each input.
+ * @param [in] params The parameters of the sponge hash.
+ */
+goldilocks_error_t goldilocks_sha3_hash_x8 (
+    uint8_t *const out[8],
+    size_t outlen,
+    const uint8_t *const in[8],
+    size_t inlen,
+    const struct goldilocks_kparams_s *params
+) GOLDILOCKS_API_VIS;
+
+/**
+ * @brief KangarooTwelve: a tree hash on Keccak-p[1600] with 12 rounds.
+ * Inputs longer than 8KiB are split into chunks, which are hashed
+ * several at a time.
+ * @param [out] out A buffer for the output data.
+ * @param [in] outlen The length of the output data.
+ * @param [in] in The input data.
+ * @param [in] inlen The length of the input data.
+ * @param [in] custom The customization string, which may be empty.
+ * @param [in] customlen The length of the customization string.
+ */
+goldilocks_error_t goldilocks_kangarootwelve (
+    uint8_t *out,
+    size_t outlen,
+    const uint8_t *in,
+    size_t inlen,
+    const uint8_t *custom,
+    size_t customlen
+) GOLDILOCKS_API_VIS;
+
+/**
+ * @brief ParallelHash128 from NIST SP 800-185.  The input is split into
+ * blocks of blocklen bytes, which are hashed several at a time.
+ * @param [out] out A buffer for the output data.
+ * @param [in] outlen The length of the output data.
+ * @param [in] in The input data.
+ * @param [in] inlen The length of the input data.
+ * @param [in] blocklen The block size in bytes.
+ * @param [in] custom The customization string, which may be empty.
+ * @param [in] customlen The length of the customization string.
+ * @return GOLDILOCKS_FAILURE if blocklen is 0.
+ * @return GOLDILOCKS_SUCCESS otherwise.
+ */
+goldilocks_error_t goldilocks_parallelhash128 (
+    uint8_t *out,
+    size_t outlen,
+    const uint8_t *in,
+    size_t inlen,
+    size_t blocklen,
+    const uint8_t *custom,
+    size_t customlen
+) GOLDILOCKS_API_VIS;
+
+/**
+ * @brief ParallelHash256 from NIST SP 800-185.  The input is split into
+ * blocks of blocklen bytes, which are hashed several at a time.
+ * @param [out] out A buffer for the output data.
+ * @param [in] outlen The length of the output data.
+ * @param [in] in The input data.
+ * @param [in] inlen The length of the input data.
+ * @param [in] blocklen The block size in bytes.
+ * @param [in] custom The customization string, which may be empty.
+ * @param [in] customlen The length of the customization string.
+ * @return GOLDILOCKS_FAILURE if blocklen is 0.
+ * @return GOLDILOCKS_SUCCESS otherwise.
+ */
+goldilocks_error_t goldilocks_parallelhash256 (
+    uint8_t *out,
+    size_t outlen,
+    const uint8_t *in,
+    size_t inlen,
+    size_t blocklen,
+    const uint8_t *custom,
+    size_t customlen
+) GOLDILOCKS_API_VIS;
+
 /* FUTURE: expand/doxygenate individual GOLDILOCKS_SHAKE/GOLDILOCKS_SHA3 instances? */
 
 /** @cond internal */
@@ -172,6 +274,12 @@ goldilocks_error_t goldilocks_sha3_hash (
     static inline void  GOLDILOCKS_NONNULL goldilocks_shake##n##_hash(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen) { \
         goldilocks_sha3_hash(out,outlen,in,inlen,&GOLDILOCKS_SHAKE##n##_params_s); \
     } \
+    static inline void  GOLDILOCKS_NONNULL goldilocks_shake##n##_x4_hash(uint8_t *const out[4], size_t outlen, const uint8_t *const in[4], size_t inlen) { \
+        goldilocks_sha3_hash_x4(out,outlen,in,inlen,&GOLDILOCKS_SHAKE##n##_params_s); \
+    } \
+    static inline void  GOLDILOCKS_NONNULL goldilocks_shake##n##_x8_hash(uint8_t *const out[8], size_t outlen, const uint8_t *const in[8], size_t inlen) { \
+        goldilocks_sha3_hash_x8(out,outlen,in,inlen,&GOLDILOCKS_SHAKE##n##_params_s); \
+    } \
     static inline void  GOLDILOCKS_NONNULL goldilocks_shake##n##_destroy(goldilocks_shake##n##_ctx_p sponge) { \
         goldilocks_sha3_destroy(sponge->s); \
     }
@@ -174,7 +174,54 @@ public:
     }
 };
 
+/** KangarooTwelve tree hash */
+class KangarooTwelve {
+public:
+    /** Hash bytes, with an optional customization string */
+    static inline SecureBuffer hash(
+        const Block &b, size_t outlen, const Block &custom = Block(NULL,0)
+    ) /*throw(std::bad_alloc)*/ {
+        SecureBuffer out(outlen);
+        goldilocks_kangarootwelve(out.data(),outlen,b.data(),b.size(),custom.data(),custom.size());
+        return out;
+    }
+};
+
+/** SP 800-185 ParallelHash, with bits = 128 or 256 */
+template<int bits> class ParallelHash {
+public:
+    /** Hash bytes in blocks of blocklen bytes, with an optional customization string.
+     * @throw LengthException if blocklen is 0.
+     */
+    static inline SecureBuffer hash(
+        const Block &b, size_t blocklen, size_t outlen, const Block &custom = Block(NULL,0)
+    ) /*throw(std::bad_alloc, LengthException)*/;
+};
+
 /** @cond internal */
+template<> inline SecureBuffer ParallelHash<128>::hash(
+    const Block &b, size_t blocklen, size_t outlen, const Block &custom
+) {
+    SecureBuffer out(outlen);
+    if (GOLDILOCKS_SUCCESS != goldilocks_parallelhash128(
+        out.data(),outlen,b.data(),b.size(),blocklen,custom.data(),custom.size()
+    )) {
+        throw LengthException();
+    }
+    return out;
+}
+template<> inline SecureBuffer ParallelHash<256>::hash(
+    const Block &b, size_t blocklen, size_t outlen, const Block &custom
+) {
+    SecureBuffer out(outlen);
+    if (GOLDILOCKS_SUCCESS != goldilocks_parallelhash256(
+        out.data(),outlen,b.data(),b.size(),blocklen,custom.data(),custom.size()
+    )) {
+        throw LengthException();
+    }
+    return out;
+}
+
 template<> inline const struct goldilocks_kparams_s *SHAKE<128>::get_params() { return &GOLDILOCKS_SHAKE128_params_s; }
 template<> inline const struct goldilocks_kparams_s *SHAKE<256>::get_params() { return &GOLDILOCKS_SHAKE256_params_s; }
 template<> inline const struct goldilocks_kparams_s *SHA3<224>::get_params() { return  &GOLDILOCKS_SHA3_224_params_s; }
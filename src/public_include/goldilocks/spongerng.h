@@ -49,7 +49,9 @@ goldilocks_error_t goldilocks_spongerng_init_from_file (
 ) GOLDILOCKS_NONNULL GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED;
 
 /**
- * @brief Initialize a nondeterministic sponge-based CSPRNG from /dev/urandom.
+ * @brief Initialize a nondeterministic sponge-based CSPRNG from the OS's entropy.
+ * This uses getrandom(2) where the kernel has it, so it needn't open /dev/urandom,
+ * and falls back to reading /dev/urandom.
  * @retval GOLDILOCKS_SUCCESS success.
  * @retval GOLDILOCKS_FAILURE failure.
  * @note On failure, errno can be used to determine the cause.
@@ -72,6 +74,53 @@ void goldilocks_spongerng_stir (
     size_t len                       /**< [in]  The length of the initial data. */
 ) GOLDILOCKS_NONNULL GOLDILOCKS_API_VIS;
 
+/**
+ * @brief Output bytes from this thread's own nondeterministic CSPRNG.
+ *
+ * Each thread has a CSPRNG, seeded from the OS on first use, and reads
+ * are served from a buffer of its output so that short reads are cheap.
+ * Bytes are erased from the buffer as they are handed out.  The CSPRNG is
+ * reseeded in a child process after fork(), and after it has output the
+ * number of bytes or run for the number of seconds set with
+ * goldilocks_thread_rng_set_reseed, or else by the background thread
+ * started with goldilocks_thread_rng_background_reseed.
+ *
+ * @retval GOLDILOCKS_SUCCESS success.
+ * @retval GOLDILOCKS_FAILURE failure to seed or set up the CSPRNG, in which case out is zeroed.
+ * @note On failure, errno can be used to determine the cause.
+ */
+goldilocks_error_t goldilocks_thread_rng_read (
+    uint8_t *__restrict__ out, /**< [out] Output buffer. */
+    size_t len                 /**< [in]  Number of bytes to output. */
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED;
+
+/**
+ * @brief Set when goldilocks_thread_rng_read reseeds, for all threads.
+ * The default is every 2^20 bytes or 300 seconds, whichever comes first.
+ * The limits are checked when the buffer is refilled.
+ */
+void goldilocks_thread_rng_set_reseed (
+    uint64_t bytes,      /**< [in] Reseed after this many bytes, or 0 for never. */
+    unsigned int seconds /**< [in] Reseed after this many seconds, or 0 for never. */
+) GOLDILOCKS_API_VIS;
+
+/**
+ * @brief Gather entropy for goldilocks_thread_rng_read on a background thread.
+ *
+ * Every few seconds, the thread reads fresh entropy from the OS, and each
+ * thread's CSPRNG stirs it in when it next refills its buffer.  This keeps
+ * syscalls off the callers' path: while the thread runs and its reads
+ * succeed, it takes the place of the limits set with
+ * goldilocks_thread_rng_set_reseed.  The thread doesn't survive fork(), so
+ * call this again in the child if need be.
+ *
+ * @retval GOLDILOCKS_SUCCESS success.
+ * @retval GOLDILOCKS_FAILURE the thread couldn't be started.
+ */
+goldilocks_error_t goldilocks_thread_rng_background_reseed (
+    unsigned int seconds /**< [in] Seconds between reads from the OS, or 0 to stop the thread. */
+) GOLDILOCKS_API_VIS GOLDILOCKS_WARN_UNUSED;
+
 /** Securely destroy a sponge RNG object by overwriting it. */
 static GOLDILOCKS_INLINE void
 goldilocks_spongerng_destroy (
@@ -18,6 +18,7 @@
 #include <goldilocks/spongerng.h>
 
 #include <string>
+#include <stdlib.h>
 #include <sys/types.h>
 #include <errno.h>
 
@@ -63,10 +64,15 @@ public:
         goldilocks_spongerng_init_from_buffer(sp,in.data(),in.size(),(int)det);
     }
 
-    /** Initialize, non-deterministically by default, from C/C++ filename */
+    /**
+     * Initialize, non-deterministically by default, from C/C++ filename.
+     * A random RNG from /dev/urandom is seeded with getrandom(2) instead if possible.
+     */
     inline SpongeRng( const std::string &in = "/dev/urandom", size_t len = 32, Deterministic det = RANDOM )
         /*throw(RngException)*/ {
-        goldilocks_error_t ret = goldilocks_spongerng_init_from_file(sp,in.c_str(),len,det);
+        goldilocks_error_t ret = (det == RANDOM && len <= 64 && in == "/dev/urandom")
+            ? goldilocks_spongerng_init_from_dev_urandom(sp)
+            : goldilocks_spongerng_init_from_file(sp,in.c_str(),len,det);
         if (!goldilocks_successful(ret)) {
             throw RngException(errno, "Couldn't load from file");
         }
@@ -93,6 +99,46 @@ private:
     SpongeRng(const SpongeRng &) GOLDILOCKS_DELETE;
     SpongeRng &operator=(const SpongeRng &) GOLDILOCKS_DELETE;
 };
+
+/**
+ * Nondeterministic random-number generator backed by a CSPRNG per thread.
+ * The object holds no state, so it is cheap to make one wherever it is needed.
+ * See goldilocks_thread_rng_read.
+ */
+class ThreadRng : public Rng {
+public:
+    /** Seed this thread's CSPRNG, if it hasn't been seeded yet. */
+    inline ThreadRng() /*throw(SpongeRng::RngException)*/ {
+        uint8_t dummy;
+        if (!goldilocks_successful(goldilocks_thread_rng_read(&dummy,0))) {
+            throw SpongeRng::RngException(errno, "Couldn't seed the thread RNG");
+        }
+    }
+
+    /**
+     * Gather entropy for all threads' RNGs on a background thread.
+     * @param [in] seconds Seconds between reads from the OS, or 0 to stop the thread.
+     * See goldilocks_thread_rng_background_reseed.
+     */
+    static inline void background_reseed(unsigned int seconds) /*throw(SpongeRng::RngException)*/ {
+        if (!goldilocks_successful(goldilocks_thread_rng_background_reseed(seconds))) {
+            throw SpongeRng::RngException(errno, "Couldn't start the reseed thread");
+        }
+    }
+
+    using Rng::read;
+
+    /** Read data to a buffer.  Aborts if the RNG can't be seeded, which a constructed ThreadRng only hits on a new thread. */
+    virtual inline void read(Buffer buffer) GOLDILOCKS_NOEXCEPT
+#if __cplusplus >= 201103L
+        final
+#endif
+        {
+            if (!goldilocks_successful(goldilocks_thread_rng_read(buffer.data(),buffer.size()))) {
+                abort();
+            }
+        }
+};
 /**@endcond*/
 
 } /* namespace goldilocks */
@@ -0,0 +1,255 @@
+/**
+ * @file safegcd.c
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * @brief Constant-time modular inversion by Bernstein-Yang divsteps.
+ *
+ * This follows "Fast constant-time gcd computation and modular inversion"
+ * (Bernstein and Yang, 2019), in the form used by libsecp256k1: numbers are
+ * kept as signed limbs of ARCH_WORD_BITS-2 bits, and a word's worth of
+ * divsteps is done at a time on the low limbs only, giving a 2x2 transition
+ * matrix which is then applied to the whole of f, g and d, e.
+ */
+
+#include "word.h"
+#include "safegcd.h"
+
+#define LIMB_BITS (ARCH_WORD_BITS-2)
+#define LIMB_MASK ((((word_t)1)<<LIMB_BITS)-1)
+
+/* Room for values in (-2*modulus, modulus), with a signed top limb */
+#define NLIMBS ((SAFEGCD_BYTES*8 + 2 + LIMB_BITS-1) / LIMB_BITS)
+
+/* Divsteps from delta=1 that reach g=0 for any f, g < 2^448:
+ * floor((49*448 + 57)/17), from Theorem 11.2 of the paper.
+ */
+#define DIVSTEPS 1294
+#define ITERATIONS ((DIVSTEPS + LIMB_BITS) / LIMB_BITS)
+
+typedef struct { sword_t v[NLIMBS]; } signed_limbs_t;
+
+/* [u v; q r] / 2^LIMB_BITS maps the (f, g) before a batch of divsteps to
+ * the (f, g) after it.
+ */
+typedef struct { sword_t u, v, q, r; } trans_t;
+
+typedef struct {
+    signed_limbs_t m;
+    word_t m_inv; /* 1/m mod 2^LIMB_BITS */
+} modinfo_t;
+
+static void from_bytes (
+    signed_limbs_t *out,
+    const uint8_t in[SAFEGCD_BYTES]
+) {
+    dword_t acc = 0;
+    int bits = 0;
+    unsigned int i, j = 0;
+    for (i=0; i<SAFEGCD_BYTES; i++) {
+        acc |= ((dword_t)in[i]) << bits;
+        bits += 8;
+        if (bits >= LIMB_BITS) {
+            out->v[j++] = (sword_t)((word_t)acc & LIMB_MASK);
+            acc >>= LIMB_BITS;
+            bits -= LIMB_BITS;
+        }
+    }
+    for (; j<NLIMBS; j++) {
+        out->v[j] = (sword_t)((word_t)acc & LIMB_MASK);
+        acc >>= LIMB_BITS;
+    }
+}
+
+/* Requires 0 <= in, with all but the top limb in range */
+static void to_bytes (
+    uint8_t out[SAFEGCD_BYTES],
+    const signed_limbs_t *in
+) {
+    dword_t acc = 0;
+    int bits = 0;
+    unsigned int i, j = 0;
+    for (i=0; i<SAFEGCD_BYTES; i++) {
+        if (bits < 8 && j < NLIMBS) {
+            acc |= ((dword_t)(word_t)in->v[j++]) << bits;
+            bits += LIMB_BITS;
+        }
+        out[i] = (uint8_t)acc;
+        acc >>= 8;
+        bits -= 8;
+    }
+}
+
+/* Do LIMB_BITS divsteps on the low bits of f and g.  eta is -delta. */
+static sword_t divsteps (
+    sword_t eta,
+    word_t f,
+    word_t g,
+    trans_t *t
+) {
+    word_t u = 1, v = 0, q = 0, r = 1, c1, c2, x, y, z;
+    int i;
+
+    for (i=0; i<LIMB_BITS; i++) {
+        /* Invariant: 2^i f = u f0 + v g0, 2^i g = q f0 + r g0 */
+        c1 = (word_t)(eta >> (ARCH_WORD_BITS-1)); /* delta > 0 */
+        c2 = -(g & 1);                            /* g odd */
+        x = (f ^ c1) - c1;
+        y = (u ^ c1) - c1;
+        z = (v ^ c1) - c1;
+        g += x & c2;
+        q += y & c2;
+        r += z & c2;
+        c1 &= c2;                                 /* swap f and g */
+        eta = (eta ^ (sword_t)c1) - ((sword_t)c1 + 1);
+        f += g & c1;
+        u += q & c1;
+        v += r & c1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+
+    t->u = (sword_t)u;
+    t->v = (sword_t)v;
+    t->q = (sword_t)q;
+    t->r = (sword_t)r;
+    return eta;
+}
+
+/* (f, g) = t (f, g) / 2^LIMB_BITS, which is exact */
+static void update_fg (
+    signed_limbs_t *f,
+    signed_limbs_t *g,
+    const trans_t *t
+) {
+    const sword_t u = t->u, v = t->v, q = t->q, r = t->r;
+    dsword_t cf, cg;
+    unsigned int i;
+
+    cf = (dsword_t)u*f->v[0] + (dsword_t)v*g->v[0];
+    cg = (dsword_t)q*f->v[0] + (dsword_t)r*g->v[0];
+    cf >>= LIMB_BITS;
+    cg >>= LIMB_BITS;
+    for (i=1; i<NLIMBS; i++) {
+        cf += (dsword_t)u*f->v[i] + (dsword_t)v*g->v[i];
+        cg += (dsword_t)q*f->v[i] + (dsword_t)r*g->v[i];
+        f->v[i-1] = (sword_t)((word_t)cf & LIMB_MASK);
+        g->v[i-1] = (sword_t)((word_t)cg & LIMB_MASK);
+        cf >>= LIMB_BITS;
+        cg >>= LIMB_BITS;
+    }
+    f->v[NLIMBS-1] = (sword_t)cf;
+    g->v[NLIMBS-1] = (sword_t)cg;
+}
+
+/* (d, e) = t (d, e) / 2^LIMB_BITS mod m, keeping both in (-2m, m) */
+static void update_de (
+    signed_limbs_t *d,
+    signed_limbs_t *e,
+    const trans_t *t,
+    const modinfo_t *mod
+) {
+    const sword_t u = t->u, v = t->v, q = t->q, r = t->r;
+    sword_t sd, se, md, me;
+    dsword_t cd, ce;
+    unsigned int i;
+
+    /* Add m*u, m*q if d < 0 and m*v, m*r if e < 0, to keep the result above -2m */
+    sd = d->v[NLIMBS-1] >> (ARCH_WORD_BITS-1);
+    se = e->v[NLIMBS-1] >> (ARCH_WORD_BITS-1);
+    md = (u & sd) + (v & se);
+    me = (q & sd) + (r & se);
+
+    cd = (dsword_t)u*d->v[0] + (dsword_t)v*e->v[0];
+    ce = (dsword_t)q*d->v[0] + (dsword_t)r*e->v[0];
+
+    /* Then add the multiple of m that clears the bottom limb */
+    md -= (sword_t)((mod->m_inv * (word_t)cd + (word_t)md) & LIMB_MASK);
+    me -= (sword_t)((mod->m_inv * (word_t)ce + (word_t)me) & LIMB_MASK);
+    cd += (dsword_t)mod->m.v[0]*md;
+    ce += (dsword_t)mod->m.v[0]*me;
+    cd >>= LIMB_BITS;
+    ce >>= LIMB_BITS;
+
+    for (i=1; i<NLIMBS; i++) {
+        cd += (dsword_t)u*d->v[i] + (dsword_t)v*e->v[i] + (dsword_t)mod->m.v[i]*md;
+        ce += (dsword_t)q*d->v[i] + (dsword_t)r*e->v[i] + (dsword_t)mod->m.v[i]*me;
+        d->v[i-1] = (sword_t)((word_t)cd & LIMB_MASK);
+        e->v[i-1] = (sword_t)((word_t)ce & LIMB_MASK);
+        cd >>= LIMB_BITS;
+        ce >>= LIMB_BITS;
+    }
+    d->v[NLIMBS-1] = (sword_t)cd;
+    e->v[NLIMBS-1] = (sword_t)ce;
+}
+
+static void carry (signed_limbs_t *a) {
+    unsigned int i;
+    for (i=0; i<NLIMBS-1; i++) {
+        a->v[i+1] += a->v[i] >> LIMB_BITS;
+        a->v[i] = (sword_t)((word_t)a->v[i] & LIMB_MASK);
+    }
+}
+
+/* Map d in (-2m, m) to (d * sign(f)) mod m, in [0, m) */
+static void normalize (
+    signed_limbs_t *d,
+    sword_t f_top,
+    const modinfo_t *mod
+) {
+    sword_t add, neg = f_top >> (ARCH_WORD_BITS-1);
+    unsigned int i;
+
+    add = d->v[NLIMBS-1] >> (ARCH_WORD_BITS-1);
+    for (i=0; i<NLIMBS; i++) d->v[i] += mod->m.v[i] & add;
+    carry(d);
+
+    for (i=0; i<NLIMBS; i++) d->v[i] = (d->v[i] ^ neg) - neg;
+    carry(d);
+
+    add = d->v[NLIMBS-1] >> (ARCH_WORD_BITS-1);
+    for (i=0; i<NLIMBS; i++) d->v[i] += mod->m.v[i] & add;
+    carry(d);
+}
+
+void goldilocks_safegcd_invert (
+    uint8_t out[SAFEGCD_BYTES],
+    const uint8_t in[SAFEGCD_BYTES],
+    const uint8_t modulus[SAFEGCD_BYTES]
+) {
+    modinfo_t mod;
+    signed_limbs_t d, e, f, g;
+    trans_t t;
+    sword_t eta = -1; /* delta = 1 */
+    word_t inv;
+    unsigned int i;
+
+    from_bytes(&mod.m, modulus);
+    inv = (word_t)mod.m.v[0]; /* correct to 3 bits, since m is odd */
+    for (i=0; i<5; i++) inv *= 2 - (word_t)mod.m.v[0]*inv;
+    mod.m_inv = inv & LIMB_MASK;
+
+    /* Invariant: d*in = f and e*in = g, mod m */
+    for (i=0; i<NLIMBS; i++) d.v[i] = e.v[i] = 0;
+    e.v[0] = 1;
+    f = mod.m;
+    from_bytes(&g, in);
+
+    for (i=0; i<ITERATIONS; i++) {
+        eta = divsteps(eta, (word_t)f.v[0], (word_t)g.v[0], &t);
+        update_de(&d, &e, &t, &mod);
+        update_fg(&f, &g, &t);
+    }
+
+    /* Now g = 0 and f = +-gcd(in, m), which is +-1 unless in = 0 */
+    normalize(&d, f.v[NLIMBS-1], &mod);
+    to_bytes(out, &d);
+
+    goldilocks_bzero(&d, sizeof(d));
+    goldilocks_bzero(&e, sizeof(e));
+    goldilocks_bzero(&f, sizeof(f));
+    goldilocks_bzero(&g, sizeof(g));
+    goldilocks_bzero(&t, sizeof(t));
+}
@@ -13,6 +13,9 @@
 #include "constant_time.h"
 #include <goldilocks.h>
 #include "api.h"
+#if GOLDILOCKS_SAFEGCD
+#include "safegcd.h"
+#endif
 
 static const goldilocks_word_t MONTGOMERY_FACTOR = (goldilocks_word_t)0x3bd440fae918bc5ull;
 static const scalar_p sc_p = {{{
@@ -104,6 +107,20 @@ static GOLDILOCKS_INLINE void sc_montsqr (scalar_p out, const scalar_p a) {
     sc_montmul(out,a,a);
 }
 
+#if GOLDILOCKS_SAFEGCD
+goldilocks_error_t API_NS(scalar_invert) (
+    scalar_p out,
+    const scalar_p a
+) {
+    uint8_t buf[SCALAR_SER_BYTES], modulus[SCALAR_SER_BYTES];
+    API_NS(scalar_encode)(modulus,sc_p);
+    API_NS(scalar_encode)(buf,a);
+    goldilocks_safegcd_invert(buf,buf,modulus);
+    ignore_result(API_NS(scalar_decode)(out,buf));
+    goldilocks_bzero(buf, sizeof(buf));
+    return goldilocks_succeed_if(~API_NS(scalar_eq)(out,API_NS(scalar_zero)));
+}
+#else
 goldilocks_error_t API_NS(scalar_invert) (
     scalar_p out,
     const scalar_p a
@@ -164,6 +181,54 @@ goldilocks_error_t API_NS(scalar_invert) (
     goldilocks_bzero(precmp, sizeof(precmp));
     return goldilocks_succeed_if(~API_NS(scalar_eq)(out,API_NS(scalar_zero)));
 }
+#endif /* GOLDILOCKS_SAFEGCD */
+
+goldilocks_error_t API_NS(scalar_batch_invert) (
+    scalar_p *__restrict__ out,
+    const scalar_p *in,
+    size_t n
+) {
+    /* Montgomery's trick on Montgomery-form prefix products:
+     * out[i] = prod(in[0..i-1]) / R^(i-1), acc = prod(in[0..n-1]) / R^(n-1).
+     * Inverting acc normally gives R^(n-1)/prod, and each montmul on the way
+     * back down removes one factor of R, leaving out[i] = 1/in[i].
+     */
+    scalar_p acc, inv, ai;
+    goldilocks_bool_t zero, nonzero = GOLDILOCKS_TRUE;
+    size_t i;
+
+    if (n == 0) return GOLDILOCKS_SUCCESS;
+
+    /* Zeros are replaced by 1 so that they don't spoil the product */
+    for (i=0; i<n; i++) {
+        zero = API_NS(scalar_eq)(in[i],API_NS(scalar_zero));
+        nonzero &= ~zero;
+        API_NS(scalar_cond_sel)(ai,in[i],API_NS(scalar_one),zero);
+        if (i == 0) {
+            API_NS(scalar_copy)(acc,ai);
+        } else {
+            API_NS(scalar_copy)(out[i],acc);
+            sc_montmul(acc,acc,ai);
+        }
+    }
+
+    ignore_result(API_NS(scalar_invert)(inv,acc));
+
+    for (i=n-1; i>0; i--) {
+        zero = API_NS(scalar_eq)(in[i],API_NS(scalar_zero));
+        API_NS(scalar_cond_sel)(ai,in[i],API_NS(scalar_one),zero);
+        sc_montmul(out[i],out[i],inv);
+        API_NS(scalar_cond_sel)(out[i],out[i],API_NS(scalar_zero),zero);
+        sc_montmul(inv,inv,ai);
+    }
+    zero = API_NS(scalar_eq)(in[0],API_NS(scalar_zero));
+    API_NS(scalar_cond_sel)(out[0],inv,API_NS(scalar_zero),zero);
+
+    API_NS(scalar_destroy)(acc);
+    API_NS(scalar_destroy)(inv);
+    API_NS(scalar_destroy)(ai);
+    return goldilocks_succeed_if(nonzero);
+}
 
 void API_NS(scalar_sub) (
     scalar_p out,
@@ -0,0 +1,232 @@
+/**
+ * @file secure_pool.c
+ * @copyright
+ *   Copyright (c) 2018 the libgoldilocks contributors.  \n
+ *   Released under the MIT License.  See LICENSE.txt for license information.
+ *
+ * @brief A pool of locked memory for small secret buffers.
+ *
+ * The pool reserves one region of address space per size class, and
+ * mlocks it a slab at a time as it grows, so that goldilocks_secure_free
+ * can tell its blocks from malloc's by their address.  Each thread keeps a
+ * short free list of each class, and trades half of it with a shared list
+ * when it runs dry or fills up.
+ */
+
+#define _DEFAULT_SOURCE 1 /* for MAP_ANONYMOUS */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <goldilocks/common.h>
+
+#define POOL_CLASSES 2
+#define SLAB_BYTES (64*1024)
+#define THREAD_CACHE 32 /* Most blocks of each class kept by a thread */
+
+/* Sized for 56- and 57-byte keys, and 112- and 114-byte signatures */
+static const size_t class_bytes[POOL_CLASSES] = { 64, 128 };
+
+typedef struct block_s { struct block_s *next; } block_s;
+
+typedef struct {
+    uint8_t *base;
+    size_t reserved, locked, used; /* reserved never changes once the pool is enabled */
+    int full;
+    block_s *free;
+} pool_class_s;
+
+typedef struct {
+    block_s *head[POOL_CLASSES];
+    unsigned int count[POOL_CLASSES];
+} thread_cache_s;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pool_class_s pool[POOL_CLASSES];
+static int pool_enabled = 0;
+static pthread_key_t cache_key;
+static __thread thread_cache_s *my_cache __attribute__((tls_model("initial-exec")));
+
+static int size_class (size_t size) {
+    int c;
+    if (!__atomic_load_n(&pool_enabled, __ATOMIC_ACQUIRE)) return -1;
+    for (c=0; c<POOL_CLASSES; c++) {
+        if (size <= class_bytes[c]) return c;
+    }
+    return -1;
+}
+
+static int owner_class (const void *p) {
+    int c;
+    if (!__atomic_load_n(&pool_enabled, __ATOMIC_ACQUIRE)) return -1;
+    for (c=0; c<POOL_CLASSES; c++) {
+        const uint8_t *q = (const uint8_t *)p;
+        if (q >= pool[c].base && q < pool[c].base + pool[c].reserved) return c;
+    }
+    return -1;
+}
+
+/* Take up to n blocks of class c from the shared list, or else carve them
+ * from the locked region, onto *head.  Called with pool_lock held.
+ */
+static unsigned int pool_take (block_s **head, int c, unsigned int n) {
+    pool_class_s *pc = &pool[c];
+    unsigned int got = 0;
+
+    for (; got < n && pc->free; got++) {
+        block_s *b = pc->free;
+        pc->free = b->next;
+        b->next = *head;
+        *head = b;
+    }
+    for (; got < n; got++) {
+        block_s *b;
+        if (pc->used + class_bytes[c] > pc->locked) {
+            if (pc->full || pc->locked + SLAB_BYTES > pc->reserved) break;
+            if (mlock(pc->base + pc->locked, SLAB_BYTES)) {
+                /* Probably RLIMIT_MEMLOCK; don't try again */
+                pc->full = 1;
+                break;
+            }
+            pc->locked += SLAB_BYTES;
+        }
+        b = (block_s *)(pc->base + pc->used);
+        pc->used += class_bytes[c];
+        b->next = *head;
+        *head = b;
+    }
+    return got;
+}
+
+/* Give n blocks of class c from *head back to the shared list.  Called with pool_lock held. */
+static void pool_give (block_s **head, int c, unsigned int n) {
+    for (; n && *head; n--) {
+        block_s *b = *head;
+        *head = b->next;
+        b->next = pool[c].free;
+        pool[c].free = b;
+    }
+}
+
+static void cache_destroy (void *arg) {
+    thread_cache_s *cache = (thread_cache_s *)arg;
+    int c;
+    pthread_mutex_lock(&pool_lock);
+    for (c=0; c<POOL_CLASSES; c++) pool_give(&cache->head[c], c, cache->count[c]);
+    pthread_mutex_unlock(&pool_lock);
+    my_cache = NULL;
+    free(cache);
+}
+
+static thread_cache_s *get_cache (void) {
+    thread_cache_s *cache = my_cache;
+    if (cache == NULL) {
+        /* The key is only for its destructor */
+        cache = (thread_cache_s *)calloc(1, sizeof(*cache));
+        if (cache && pthread_setspecific(cache_key, cache)) {
+            free(cache);
+            cache = NULL;
+        }
+        my_cache = cache;
+    }
+    return cache;
+}
+
+goldilocks_error_t goldilocks_secure_pool_enable (size_t max_bytes) {
+    goldilocks_error_t ret = GOLDILOCKS_SUCCESS;
+    size_t per_class = (max_bytes / POOL_CLASSES) / SLAB_BYTES * SLAB_BYTES;
+    int c;
+
+    if (per_class == 0) per_class = SLAB_BYTES;
+
+    pthread_mutex_lock(&pool_lock);
+    if (pool_enabled) goto done;
+    if (pthread_key_create(&cache_key, cache_destroy)) {
+        ret = GOLDILOCKS_FAILURE;
+        goto done;
+    }
+    for (c=0; c<POOL_CLASSES; c++) {
+        void *base = mmap(NULL, per_class, PROT_READ|PROT_WRITE,
+            MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+        if (base == MAP_FAILED) {
+            for (c--; c>=0; c--) munmap(pool[c].base, pool[c].reserved);
+            pthread_key_delete(cache_key);
+            ret = GOLDILOCKS_FAILURE;
+            goto done;
+        }
+#ifdef MADV_DONTDUMP
+        (void)madvise(base, per_class, MADV_DONTDUMP);
+#endif
+        pool[c].base = (uint8_t *)base;
+        pool[c].reserved = per_class;
+    }
+    __atomic_store_n(&pool_enabled, 1, __ATOMIC_RELEASE);
+
+done:
+    pthread_mutex_unlock(&pool_lock);
+    return ret;
+}
+
+void *goldilocks_secure_malloc (size_t size) {
+    int c = size_class(size);
+    thread_cache_s *cache;
+    block_s *b = NULL;
+
+    if (c < 0) return malloc(size);
+
+    cache = get_cache();
+    if (cache == NULL) {
+        pthread_mutex_lock(&pool_lock);
+        pool_take(&b, c, 1);
+        pthread_mutex_unlock(&pool_lock);
+        return b ? (void *)b : malloc(size);
+    }
+
+    if (cache->head[c] == NULL) {
+        pthread_mutex_lock(&pool_lock);
+        cache->count[c] = pool_take(&cache->head[c], c, THREAD_CACHE/2);
+        pthread_mutex_unlock(&pool_lock);
+        if (cache->head[c] == NULL) return malloc(size);
+    }
+
+    b = cache->head[c];
+    cache->head[c] = b->next;
+    cache->count[c]--;
+    b->next = NULL;
+    return b;
+}
+
+void goldilocks_secure_free (void *p, size_t size) {
+    int c;
+    thread_cache_s *cache;
+    block_s *b = (block_s *)p;
+
+    if (p == NULL) return;
+
+    c = owner_class(p);
+    if (c < 0) {
+        goldilocks_bzero(p, size);
+        free(p);
+        return;
+    }
+
+    goldilocks_bzero(p, class_bytes[c]);
+    cache = get_cache();
+    if (cache == NULL) {
+        b->next = NULL;
+        pthread_mutex_lock(&pool_lock);
+        pool_give(&b, c, 1);
+        pthread_mutex_unlock(&pool_lock);
+        return;
+    }
+
+    b->next = cache->head[c];
+    cache->head[c] = b;
+    if (++cache->count[c] > THREAD_CACHE) {
+        pthread_mutex_lock(&pool_lock);
+        pool_give(&cache->head[c], c, THREAD_CACHE/2);
+        pthread_mutex_unlock(&pool_lock);
+        cache->count[c] -= THREAD_CACHE/2;
+    }
+}
@@ -21,6 +21,7 @@
 
 #include "portable_endian.h"
 #include "keccak_internal.h"
+#include "cpu_features.h"
 #include <goldilocks/shake.h>
 
 #define FLAG_ABSORBING 'A'
@@ -62,8 +63,6 @@ void keccakf(kdomain_u state, uint8_t start_round) {
     uint64_t b[5] = {0}, t, u;
     uint8_t x, y, i;
 
-    for (i=0; i<25; i++) a[i] = le64toh(a[i]);
-
     for (i = start_round; i < 24; i++) {
         FOR51(x, b[x] = 0; )
         FOR55(y, FOR51(x, b[x] ^= a[x + y]; ))
@@ -82,8 +81,95 @@ void keccakf(kdomain_u state, uint8_t start_round) {
         // Iota
         a[0] ^= RC[i];
     }
+}
+
+/*** Several Keccak-f[1600] permutations side by side ***/
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+/* Only these functions use AVX; callers check keccakf_x{4,8}_supported() first. */
+#define KECCAK_X4_TARGET __attribute__((target("avx2")))
+#define KECCAK_X8_TARGET __attribute__((target("avx512f")))
+
+static int keccakf_x4_supported (void) {
+    return !!(goldilocks_cpu_features() & GOLDILOCKS_CPU_AVX2);
+}
+
+static int keccakf_x8_supported (void) {
+    return !!(goldilocks_cpu_features() & GOLDILOCKS_CPU_AVX512);
+}
+#else
+/* The compiler splits the vectors up into whatever the target has */
+#define KECCAK_X4_TARGET
+#define KECCAK_X8_TARGET
+static int keccakf_x4_supported (void) { return 1; }
+static int keccakf_x8_supported (void) { return 1; }
+#endif
+
+typedef uint64_t keccak_x4_t __attribute__((vector_size(32)));
+typedef uint64_t keccak_x8_t __attribute__((vector_size(64)));
+
+#define ROLV(x, s) (((x) << (s)) | ((x) >> (64 - (s))))
+
+/* Same as the rounds in keccakf, on a[25] of any vector type. */
+#define KECCAK_ROUNDS_V(vec_t, a, start_round) do { \
+    vec_t b[5], t, u; \
+    uint8_t x, y, i; \
+    for (i = start_round; i < 24; i++) { \
+        FOR51(x, b[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20]; ) \
+        FOR55(y, FOR51(x, \
+            a[y + x] ^= b[(x + 4) % 5] ^ ROLV(b[(x + 1) % 5], 1); \
+        )) \
+        t = a[1]; \
+        x = y = 0; \
+        REPEAT24(u = a[pi[x]]; y += x+1; a[pi[x]] = ROLV(t, y % 64); t = u; x++; ) \
+        FOR55(y, \
+             FOR51(x, b[x] = a[y + x];) \
+             FOR51(x, a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]);) \
+        ) \
+        a[0] ^= RC[i]; \
+    } \
+} while (0)
+
+void KECCAK_X4_TARGET keccakf_x4(uint64_t state[25*4], uint8_t start_round) {
+    keccak_x4_t a[25];
+    memcpy(a, state, sizeof(a));
+    KECCAK_ROUNDS_V(keccak_x4_t, a, start_round);
+    memcpy(state, a, sizeof(a));
+}
+
+void KECCAK_X8_TARGET keccakf_x8(uint64_t state[25*8], uint8_t start_round) {
+    keccak_x8_t a[25];
+    memcpy(a, state, sizeof(a));
+    KECCAK_ROUNDS_V(keccak_x8_t, a, start_round);
+    memcpy(state, a, sizeof(a));
+}
+
+/*
+ * The sponge state is kept as native 64-bit lanes, and byte i of the
+ * rate is byte i%8 of lane i/8 in little-endian order.  These move bytes
+ * [pos,pos+len) in or out a lane at a time, except at unaligned ends.
+ */
+static inline void xor_byte(uint64_t *lanes, size_t pos, uint8_t x) {
+    lanes[pos/8] ^= (uint64_t)x << (8*(pos%8));
+}
+
+static void absorb_bytes(uint64_t *lanes, size_t pos, const uint8_t *in, size_t len) {
+    uint64_t w;
+    for (; len && pos%8; len--, pos++) xor_byte(lanes, pos, *in++);
+    for (; len >= 8; len -= 8, pos += 8, in += 8) {
+        memcpy(&w, in, 8);
+        lanes[pos/8] ^= le64toh(w);
+    }
+    for (; len; len--, pos++) xor_byte(lanes, pos, *in++);
+}
 
-    for (i=0; i<25; i++) a[i] = htole64(a[i]);
+static void squeeze_bytes(uint8_t *out, const uint64_t *lanes, size_t pos, size_t len) {
+    uint64_t w;
+    for (; len && pos%8; len--, pos++) *out++ = lanes[pos/8] >> (8*(pos%8));
+    for (; len >= 8; len -= 8, pos += 8, out += 8) {
+        w = htole64(lanes[pos/8]);
+        memcpy(out, &w, 8);
+    }
+    for (; len; len--, pos++) *out++ = lanes[pos/8] >> (8*(pos%8));
 }
 
 goldilocks_error_t goldilocks_sha3_update (
@@ -95,14 +181,14 @@ goldilocks_error_t goldilocks_sha3_update (
     assert(goldilocks_sponge->params->rate < sizeof(goldilocks_sponge->state));
     assert(goldilocks_sponge->params->flags == FLAG_ABSORBING);
     while (len) {
-        size_t cando = goldilocks_sponge->params->rate - goldilocks_sponge->params->position, i;
-        uint8_t* state = &goldilocks_sponge->state->b[goldilocks_sponge->params->position];
+        size_t cando = goldilocks_sponge->params->rate - goldilocks_sponge->params->position;
+        uint64_t* state = goldilocks_sponge->state->w;
         if (cando > len) {
-            for (i = 0; i < len; i += 1) state[i] ^= in[i];
+            absorb_bytes(state, goldilocks_sponge->params->position, in, len);
             goldilocks_sponge->params->position += len;
             break;
         } else {
-            for (i = 0; i < cando; i += 1) state[i] ^= in[i];
+            absorb_bytes(state, goldilocks_sponge->params->position, in, cando);
             dokeccak(goldilocks_sponge);
             len -= cando;
             in += cando;
@@ -133,9 +219,9 @@ goldilocks_error_t goldilocks_sha3_output (
     case FLAG_SQUEEZING: break;
     case FLAG_ABSORBING:
         {
-            uint8_t* state = goldilocks_sponge->state->b;
-            state[goldilocks_sponge->params->position] ^= goldilocks_sponge->params->pad;
-            state[goldilocks_sponge->params->rate - 1] ^= goldilocks_sponge->params->rate_pad;
+            uint64_t* state = goldilocks_sponge->state->w;
+            xor_byte(state, goldilocks_sponge->params->position, goldilocks_sponge->params->pad);
+            xor_byte(state, goldilocks_sponge->params->rate - 1, goldilocks_sponge->params->rate_pad);
             dokeccak(goldilocks_sponge);
             goldilocks_sponge->params->flags = FLAG_SQUEEZING;
             break;
@@ -146,13 +232,13 @@ goldilocks_error_t goldilocks_sha3_output (
 
     while (len) {
         size_t cando = goldilocks_sponge->params->rate - goldilocks_sponge->params->position;
-        uint8_t* state = &goldilocks_sponge->state->b[goldilocks_sponge->params->position];
+        const uint64_t* state = goldilocks_sponge->state->w;
         if (cando > len) {
-            memcpy(out, state, len);
+            squeeze_bytes(out, state, goldilocks_sponge->params->position, len);
             goldilocks_sponge->params->position += len;
             return ret;
         } else {
-            memcpy(out, state, cando);
+            squeeze_bytes(out, state, goldilocks_sponge->params->position, cando);
             dokeccak(goldilocks_sponge);
             len -= cando;
             out += cando;
@@ -208,6 +294,107 @@ goldilocks_error_t goldilocks_sha3_hash (
     return ret;
 }
 
+/* XOR a rate-sized block into state j of n interleaved states */
+static void absorb_lanes(uint64_t *state, unsigned int n, unsigned int j, const uint8_t *in, unsigned int rate) {
+    unsigned int i;
+    uint64_t w;
+    for (i=0; i<rate/8; i++) {
+        memcpy(&w, &in[8*i], 8);
+        state[i*n+j] ^= le64toh(w);
+    }
+}
+
+/* Copy the rate part of state j of n interleaved states out */
+static void squeeze_lanes(uint8_t *out, const uint64_t *state, unsigned int n, unsigned int j, unsigned int rate) {
+    unsigned int i;
+    uint64_t w;
+    for (i=0; i<rate/8; i++) {
+        w = htole64(state[i*n+j]);
+        memcpy(&out[8*i], &w, 8);
+    }
+}
+
+/* goldilocks_sha3_hash on n inputs of the same length at once, with permute running all n states */
+static goldilocks_error_t sha3_hash_mb (
+    uint8_t *const *out,
+    size_t outlen,
+    const uint8_t *const *in,
+    size_t inlen,
+    const struct goldilocks_kparams_s *params,
+    uint64_t *state,
+    unsigned int n,
+    void (*permute)(uint64_t *state, uint8_t start_round)
+) {
+    unsigned int rate = params->rate, j;
+    size_t pos, cando;
+    uint8_t block[200];
+    goldilocks_error_t ret = GOLDILOCKS_SUCCESS;
+    assert(rate % 8 == 0 && rate < sizeof(block));
+
+    memset(state, 0, 25*n*sizeof(*state));
+    for (pos = 0; inlen - pos >= rate; pos += rate) {
+        for (j=0; j<n; j++) absorb_lanes(state, n, j, &in[j][pos], rate);
+        permute(state, params->start_round);
+    }
+    for (j=0; j<n; j++) {
+        memset(block, 0, rate);
+        if (inlen > pos) memcpy(block, &in[j][pos], inlen - pos);
+        block[inlen - pos] ^= params->pad;
+        block[rate - 1] ^= params->rate_pad;
+        absorb_lanes(state, n, j, block, rate);
+    }
+    permute(state, params->start_round);
+
+    if (params->max_out != 0xFF && outlen > params->max_out) ret = GOLDILOCKS_FAILURE;
+
+    for (pos = 0; pos < outlen; pos += cando) {
+        if (pos) permute(state, params->start_round);
+        cando = (outlen - pos < rate) ? outlen - pos : rate;
+        for (j=0; j<n; j++) {
+            squeeze_lanes(block, state, n, j, rate);
+            memcpy(&out[j][pos], block, cando);
+        }
+    }
+
+    goldilocks_bzero(block, sizeof(block));
+    goldilocks_bzero(state, 25*n*sizeof(*state));
+    return ret;
+}
+
+goldilocks_error_t goldilocks_sha3_hash_x4 (
+    uint8_t *const out[4],
+    size_t outlen,
+    const uint8_t *const in[4],
+    size_t inlen,
+    const struct goldilocks_kparams_s *params
+) {
+    uint64_t state[25*4];
+    goldilocks_error_t ret = GOLDILOCKS_SUCCESS;
+    unsigned int j;
+    if (keccakf_x4_supported()) {
+        return sha3_hash_mb(out, outlen, in, inlen, params, state, 4, keccakf_x4);
+    }
+    for (j=0; j<4; j++) {
+        ret &= goldilocks_sha3_hash(out[j], outlen, in[j], inlen, params);
+    }
+    return ret;
+}
+
+goldilocks_error_t goldilocks_sha3_hash_x8 (
+    uint8_t *const out[8],
+    size_t outlen,
+    const uint8_t *const in[8],
+    size_t inlen,
+    const struct goldilocks_kparams_s *params
+) {
+    uint64_t state[25*8];
+    if (keccakf_x8_supported()) {
+        return sha3_hash_mb(out, outlen, in, inlen, params, state, 8, keccakf_x8);
+    }
+    return goldilocks_sha3_hash_x4(out, outlen, in, inlen, params)
+         & goldilocks_sha3_hash_x4(&out[4], outlen, &in[4], inlen, params);
+}
+
 #define DEFSHAKE(n) \
     const struct goldilocks_kparams_s GOLDILOCKS_SHAKE##n##_params_s = \
         { 0, FLAG_ABSORBING, 200-n/4, 0, 0x1f, 0x80, 0xFF, 0xFF };
@@ -239,4 +426,250 @@ DEFSHA3(256)
 DEFSHA3(384)
 DEFSHA3(512)
 
+/*** Tree hashing: KangarooTwelve and ParallelHash ***/
+
+/*
+ * Encode x in as few big-endian bytes as possible, but at least min_bytes,
+ * with the number of bytes before (SP 800-185 left_encode) or after
+ * (right_encode, and K12's length_encode with min_bytes = 0).
+ */
+static size_t encode_int(uint8_t out[9], uint64_t x, unsigned int min_bytes, int left) {
+    unsigned int n = 0, i;
+    uint8_t *digits = left ? &out[1] : out;
+    while (n < 8 && (n < min_bytes || (x >> (8*n)))) n++;
+    for (i=0; i<n; i++) digits[i] = x >> (8*(n-1-i));
+    out[left ? 0 : n] = n;
+    return n+1;
+}
+
+static void update_int(goldilocks_keccak_sponge_p sponge, uint64_t x, unsigned int min_bytes, int left) {
+    uint8_t enc[9];
+    goldilocks_sha3_update(sponge, enc, encode_int(enc, x, min_bytes, left));
+}
+
+/* Hash n inputs of the same length, eight or four at a time where possible */
+static void hash_leaves(
+    uint8_t *cv,
+    size_t cvlen,
+    const uint8_t *in,
+    size_t leaflen,
+    size_t n,
+    const struct goldilocks_kparams_s *params
+) {
+    const uint8_t *ins[8];
+    uint8_t *outs[8];
+    unsigned int j, width;
+    for (; n >= 4; n -= width) {
+        width = (n >= 8) ? 8 : 4;
+        for (j=0; j<width; j++) {
+            ins[j] = &in[j*leaflen];
+            outs[j] = &cv[j*cvlen];
+        }
+        if (width == 8) {
+            goldilocks_sha3_hash_x8(outs, cvlen, ins, leaflen, params);
+        } else {
+            goldilocks_sha3_hash_x4(outs, cvlen, ins, leaflen, params);
+        }
+        in += width*leaflen;
+        cv += width*cvlen;
+    }
+    for (; n; n--) {
+        goldilocks_sha3_hash(cv, cvlen, in, leaflen, params);
+        in += leaflen;
+        cv += cvlen;
+    }
+}
+
+#define K12_CHUNK 8192
+#define K12_CV 32
+#define K12_BATCH 64 /* chaining values per call to hash_leaves */
+#define DEFTURBOSHAKE128(name, domain) \
+    static const struct goldilocks_kparams_s name = \
+        { 0, FLAG_ABSORBING, 168, 12, domain, 0x80, 0xFF, 0xFF };
+DEFTURBOSHAKE128(K12_SINGLE_params_s, 0x07)
+DEFTURBOSHAKE128(K12_FINAL_params_s, 0x06)
+DEFTURBOSHAKE128(K12_LEAF_params_s, 0x0B)
+
+/* The K12 input string S = M || C || length_encode(|C|) */
+struct k12_string_s {
+    const uint8_t *m, *c;
+    size_t mlen, clen, enclen;
+    uint8_t enc[9];
+};
+
+/* Absorb bytes [start,end) of S */
+static void k12_update_range(
+    goldilocks_keccak_sponge_p sponge,
+    const struct k12_string_s *s,
+    size_t start,
+    size_t end
+) {
+    const uint8_t *part[3];
+    size_t partlen[3], stop;
+    unsigned int k;
+    part[0] = s->m; partlen[0] = s->mlen;
+    part[1] = s->c; partlen[1] = s->clen;
+    part[2] = s->enc; partlen[2] = s->enclen;
+    for (k=0; k<3 && start < end; k++) {
+        if (start < partlen[k]) {
+            stop = (end < partlen[k]) ? end : partlen[k];
+            goldilocks_sha3_update(sponge, &part[k][start], stop - start);
+            start = stop;
+        }
+        if (end <= partlen[k]) break;
+        start -= partlen[k];
+        end -= partlen[k];
+    }
+}
+
+goldilocks_error_t goldilocks_kangarootwelve (
+    uint8_t *out,
+    size_t outlen,
+    const uint8_t *in,
+    size_t inlen,
+    const uint8_t *custom,
+    size_t customlen
+) {
+    static const uint8_t chaining[8] = {3};
+    static const uint8_t terminator[2] = {0xFF, 0xFF};
+    struct k12_string_s s;
+    goldilocks_keccak_sponge_p final, leaf;
+    uint8_t cv[K12_BATCH*K12_CV];
+    size_t total, nchunks, i, batch;
+    goldilocks_error_t ret;
+
+    s.m = in; s.mlen = inlen;
+    s.c = custom; s.clen = customlen;
+    s.enclen = encode_int(s.enc, customlen, 0, 0);
+    total = inlen + customlen + s.enclen;
+    nchunks = (total + K12_CHUNK - 1) / K12_CHUNK;
+
+    if (nchunks <= 1) {
+        goldilocks_sha3_init(final, &K12_SINGLE_params_s);
+        k12_update_range(final, &s, 0, total);
+    } else {
+        goldilocks_sha3_init(final, &K12_FINAL_params_s);
+        k12_update_range(final, &s, 0, K12_CHUNK);
+        goldilocks_sha3_update(final, chaining, sizeof(chaining));
+
+        /* Chunks which lie entirely within M are hashed in place, several at once */
+        for (i=1; (i+1)*K12_CHUNK <= inlen; i += batch) {
+            batch = inlen/K12_CHUNK - i;
+            if (batch > K12_BATCH) batch = K12_BATCH;
+            hash_leaves(cv, K12_CV, &in[i*K12_CHUNK], K12_CHUNK, batch, &K12_LEAF_params_s);
+            goldilocks_sha3_update(final, cv, batch*K12_CV);
+        }
+        for (; i<nchunks; i++) {
+            goldilocks_sha3_init(leaf, &K12_LEAF_params_s);
+            k12_update_range(leaf, &s, i*K12_CHUNK, (i+1 < nchunks) ? (i+1)*K12_CHUNK : total);
+            goldilocks_sha3_output(leaf, cv, K12_CV);
+            goldilocks_sha3_update(final, cv, K12_CV);
+        }
+        goldilocks_sha3_destroy(leaf);
+
+        update_int(final, nchunks-1, 0, 0);
+        goldilocks_sha3_update(final, terminator, sizeof(terminator));
+    }
+
+    ret = goldilocks_sha3_output(final, out, outlen);
+    goldilocks_sha3_destroy(final);
+    goldilocks_bzero(cv, sizeof(cv));
+    return ret;
+}
+
+#define DEFCSHAKE(n) \
+    static const struct goldilocks_kparams_s CSHAKE##n##_params_s = \
+        { 0, FLAG_ABSORBING, 200-n/4, 0, 0x04, 0x80, 0xFF, 0xFF };
+DEFCSHAKE(128)
+DEFCSHAKE(256)
+
+/* Start cSHAKE with function name N and customization string S */
+static void cshake_init(
+    goldilocks_keccak_sponge_p sponge,
+    const struct goldilocks_kparams_s *params,
+    const char *name,
+    const uint8_t *custom,
+    size_t customlen
+) {
+    static const uint8_t zeros[200] = {0};
+    size_t namelen = strlen(name);
+    goldilocks_sha3_init(sponge, params);
+    update_int(sponge, params->rate, 1, 1);
+    update_int(sponge, 8*(uint64_t)namelen, 1, 1);
+    goldilocks_sha3_update(sponge, (const uint8_t *)name, namelen);
+    update_int(sponge, 8*(uint64_t)customlen, 1, 1);
+    goldilocks_sha3_update(sponge, custom, customlen);
+    if (sponge->params->position) {
+        goldilocks_sha3_update(sponge, zeros, sponge->params->rate - sponge->params->position);
+    }
+}
+
+static goldilocks_error_t parallelhash (
+    uint8_t *out,
+    size_t outlen,
+    const uint8_t *in,
+    size_t inlen,
+    size_t blocklen,
+    const uint8_t *custom,
+    size_t customlen,
+    const struct goldilocks_kparams_s *cshake,
+    const struct goldilocks_kparams_s *leaf,
+    size_t cvlen
+) {
+    goldilocks_keccak_sponge_p sponge;
+    uint8_t cv[8*64];
+    size_t nblocks, i, batch;
+    goldilocks_error_t ret;
+
+    if (blocklen == 0) return GOLDILOCKS_FAILURE;
+    nblocks = (inlen + blocklen - 1) / blocklen;
+
+    cshake_init(sponge, cshake, "ParallelHash", custom, customlen);
+    update_int(sponge, blocklen, 1, 1);
+    /* All blocks but the last are the same length */
+    for (i=0; i+1 < nblocks; i += batch) {
+        batch = nblocks - 1 - i;
+        if (batch > 8) batch = 8;
+        hash_leaves(cv, cvlen, &in[i*blocklen], blocklen, batch, leaf);
+        goldilocks_sha3_update(sponge, cv, batch*cvlen);
+    }
+    if (nblocks) {
+        goldilocks_sha3_hash(cv, cvlen, &in[i*blocklen], inlen - i*blocklen, leaf);
+        goldilocks_sha3_update(sponge, cv, cvlen);
+    }
+    update_int(sponge, nblocks, 1, 0);
+    update_int(sponge, 8*(uint64_t)outlen, 1, 0);
+
+    ret = goldilocks_sha3_output(sponge, out, outlen);
+    goldilocks_sha3_destroy(sponge);
+    goldilocks_bzero(cv, sizeof(cv));
+    return ret;
+}
+
+goldilocks_error_t goldilocks_parallelhash128 (
+    uint8_t *out,
+    size_t outlen,
+    const uint8_t *in,
+    size_t inlen,
+    size_t blocklen,
+    const uint8_t *custom,
+    size_t customlen
+) {
+    return parallelhash(out, outlen, in, inlen, blocklen, custom, customlen,
+        &CSHAKE128_params_s, &GOLDILOCKS_SHAKE128_params_s, 32);
+}
+
+goldilocks_error_t goldilocks_parallelhash256 (
+    uint8_t *out,
+    size_t outlen,
+    const uint8_t *in,
+    size_t inlen,
+    size_t blocklen,
+    const uint8_t *custom,
+    size_t customlen
+) {
+    return parallelhash(out, outlen, in, inlen, blocklen, custom, customlen,
+        &CSHAKE256_params_s, &GOLDILOCKS_SHAKE256_params_s, 64);
+}
+
 /* FUTURE: Keyak instances, etc */
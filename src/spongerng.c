@@ -12,18 +12,55 @@
  */
 
 #define __STDC_WANT_LIB_EXT1__ 1 /* for memset_s */
+#define _DEFAULT_SOURCE 1 /* for clock_gettime */
 #include <assert.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <time.h>
 
 #include "keccak_internal.h"
 #include <goldilocks/spongerng.h>
 
-/* to open and read from /dev/urandom */
+/* to get entropy from the OS */
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+/** Get entropy from the OS, preferably from getrandom(2), which works without /dev. */
+static goldilocks_error_t get_os_entropy(uint8_t *out, size_t len) {
+    int fd;
+#ifdef SYS_getrandom
+    while (len) {
+        long got = syscall(SYS_getrandom, out, len, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break; /* Probably ENOSYS on an old kernel */
+        out += got;
+        len -= got;
+    }
+    if (!len) return GOLDILOCKS_SUCCESS;
+#endif
+
+    fd = open("/dev/urandom", O_RDONLY);
+    if (fd < 0) return GOLDILOCKS_FAILURE;
+    while (len) {
+        ssize_t red = read(fd, out, len);
+        if (red <= 0) {
+            close(fd);
+            return GOLDILOCKS_FAILURE;
+        }
+        out += red;
+        len -= red;
+    }
+    close(fd);
+    return GOLDILOCKS_SUCCESS;
+}
 
 /** Get entropy from a CPU, preferably in the form of RDRAND, but possibly instead from RDTSC. */
 static void get_cpu_entropy(uint8_t *entropy, size_t len) {
@@ -180,5 +217,278 @@ goldilocks_error_t goldilocks_spongerng_init_from_file (
 goldilocks_error_t goldilocks_spongerng_init_from_dev_urandom (
     goldilocks_keccak_prng_p goldilocks_sponge
 ) {
-    return goldilocks_spongerng_init_from_file(goldilocks_sponge, "/dev/urandom", 64, 0);
+    uint8_t seed[64];
+    goldilocks_error_t ret = get_os_entropy(seed, sizeof(seed));
+    goldilocks_spongerng_init_from_buffer(goldilocks_sponge, seed, sizeof(seed), 0);
+    goldilocks_bzero(seed, sizeof(seed));
+    return ret;
+}
+
+#define THREAD_RNG_BUFFER 4096
+
+typedef struct {
+    goldilocks_keccak_prng_p prng;
+    uint8_t buffer[THREAD_RNG_BUFFER];
+    size_t avail;          /* Unread bytes, at the end of the buffer */
+    uint64_t since_seed;   /* Bytes output since the last reseed */
+    time_t seeded_at;      /* CLOCK_MONOTONIC seconds at the last reseed */
+    unsigned int forks;    /* fork_count at the last reseed */
+    uint64_t harvest;      /* harvest_epoch at the last reseed */
+    int seeded;
+} thread_rng_s;
+
+static pthread_once_t thread_rng_once = PTHREAD_ONCE_INIT;
+static pthread_key_t thread_rng_key;
+static int thread_rng_key_ok = 0;
+static __thread thread_rng_s *my_thread_rng __attribute__((tls_model("initial-exec")));
+static unsigned int fork_count = 0;
+static uint64_t reseed_bytes = 1<<20;
+static unsigned int reseed_seconds = 300;
+
+/* Entropy gathered by the background thread, waiting to be stirred in */
+static pthread_mutex_t harvest_control = PTHREAD_MUTEX_INITIALIZER; /* Held while starting or stopping */
+static pthread_mutex_t harvest_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t harvest_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t harvest_thread;
+static int harvest_running = 0; /* Only changed with harvest_lock held */
+static unsigned int harvest_seconds;
+static uint8_t harvest_seed[32];
+static uint64_t harvest_epoch = 0; /* Bumped each time harvest_seed changes */
+static int harvest_ok = 0; /* Whether the last read from the OS worked */
+
+static void fork_prepare (void) {
+    pthread_mutex_lock(&harvest_lock);
+}
+
+static void fork_parent (void) {
+    pthread_mutex_unlock(&harvest_lock);
+}
+
+static void fork_child (void) {
+    /* The harvest thread didn't come with us */
+    pthread_mutex_init(&harvest_control, NULL);
+    pthread_mutex_init(&harvest_lock, NULL);
+    pthread_cond_init(&harvest_cond, NULL);
+    __atomic_store_n(&harvest_running, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&harvest_ok, 0, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&fork_count, 1, __ATOMIC_RELAXED);
+}
+
+static void thread_rng_destroy (void *arg) {
+    thread_rng_s *rng = (thread_rng_s *)arg;
+    goldilocks_bzero(rng, sizeof(*rng));
+    free(rng);
+    my_thread_rng = NULL;
+}
+
+static void thread_rng_init (void) {
+    thread_rng_key_ok = !pthread_key_create(&thread_rng_key, thread_rng_destroy);
+    if (thread_rng_key_ok && pthread_atfork(fork_prepare, fork_parent, fork_child)) {
+        /* Without fork detection, don't hand out buffered output */
+        pthread_key_delete(thread_rng_key);
+        thread_rng_key_ok = 0;
+    }
+}
+
+static time_t monotonic_seconds (void) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts)) return 0;
+    return ts.tv_sec;
+}
+
+/* Mix in fresh entropy, and throw away anything buffered */
+static goldilocks_error_t thread_rng_reseed (thread_rng_s *rng) {
+    uint8_t seed[32];
+    struct { pid_t pid; unsigned int forks; time_t now; } ids;
+    goldilocks_error_t ret = get_os_entropy(seed, sizeof(seed));
+
+    if (!rng->seeded) {
+        if (ret != GOLDILOCKS_SUCCESS) return ret;
+        goldilocks_spongerng_init_from_buffer(rng->prng, seed, sizeof(seed), 0);
+        rng->seeded = 1;
+    } else if (ret == GOLDILOCKS_SUCCESS) {
+        goldilocks_spongerng_stir(rng->prng, seed, sizeof(seed));
+    }
+
+    /* If the OS failed us after a fork, at least make this process's stream
+     * differ from its parent's.  The next refill will try the OS again.
+     */
+    memset(&ids, 0, sizeof(ids));
+    ids.pid = getpid();
+    ids.forks = __atomic_load_n(&fork_count, __ATOMIC_RELAXED);
+    ids.now = monotonic_seconds();
+    goldilocks_spongerng_stir(rng->prng, (const uint8_t *)&ids, sizeof(ids));
+
+    goldilocks_bzero(rng->buffer, sizeof(rng->buffer));
+    rng->avail = 0;
+    rng->forks = ids.forks;
+    rng->harvest = __atomic_load_n(&harvest_epoch, __ATOMIC_ACQUIRE);
+    if (ret == GOLDILOCKS_SUCCESS) {
+        rng->since_seed = 0;
+        rng->seeded_at = ids.now;
+    }
+    goldilocks_bzero(seed, sizeof(seed));
+    return GOLDILOCKS_SUCCESS;
+}
+
+static thread_rng_s *get_thread_rng (void) {
+    thread_rng_s *rng = my_thread_rng;
+    if (rng) return rng;
+
+    pthread_once(&thread_rng_once, thread_rng_init);
+    if (!thread_rng_key_ok) return NULL;
+
+    rng = (thread_rng_s *)calloc(1, sizeof(*rng));
+    if (rng == NULL) return NULL;
+    if (thread_rng_reseed(rng) != GOLDILOCKS_SUCCESS
+        || pthread_setspecific(thread_rng_key, rng)) {
+        goldilocks_bzero(rng, sizeof(*rng));
+        free(rng);
+        return NULL;
+    }
+    my_thread_rng = rng;
+    return rng;
+}
+
+/* Reseed if we're past the budget, and note that len more bytes are going out */
+static void thread_rng_budget (thread_rng_s *rng, size_t len) {
+    uint64_t bytes;
+    unsigned int seconds;
+
+    if (__atomic_load_n(&harvest_running, __ATOMIC_RELAXED)) {
+        /* The harvest thread sets the pace, so that we don't make syscalls,
+         * unless it is failing to get entropy.
+         */
+        if (__atomic_load_n(&harvest_epoch, __ATOMIC_ACQUIRE) != rng->harvest) {
+            uint8_t seed[sizeof(harvest_seed)];
+            pthread_mutex_lock(&harvest_lock);
+            memcpy(seed, harvest_seed, sizeof(seed));
+            rng->harvest = harvest_epoch;
+            pthread_mutex_unlock(&harvest_lock);
+            goldilocks_spongerng_stir(rng->prng, seed, sizeof(seed));
+            goldilocks_bzero(seed, sizeof(seed));
+            rng->since_seed = 0;
+            rng->seeded_at = monotonic_seconds();
+        }
+        if (__atomic_load_n(&harvest_ok, __ATOMIC_RELAXED)) {
+            rng->since_seed += len;
+            return;
+        }
+    }
+
+    bytes = __atomic_load_n(&reseed_bytes, __ATOMIC_RELAXED);
+    seconds = __atomic_load_n(&reseed_seconds, __ATOMIC_RELAXED);
+    if ((bytes && rng->since_seed >= bytes)
+        || (seconds && monotonic_seconds() - rng->seeded_at >= (time_t)seconds)) {
+        (void)thread_rng_reseed(rng);
+    }
+    rng->since_seed += len;
+}
+
+goldilocks_error_t goldilocks_thread_rng_read (
+    uint8_t *__restrict__ out,
+    size_t len
+) {
+    thread_rng_s *rng = get_thread_rng();
+    if (rng == NULL) {
+        if (len) goldilocks_bzero(out, len);
+        return GOLDILOCKS_FAILURE;
+    }
+
+    if (rng->forks != __atomic_load_n(&fork_count, __ATOMIC_RELAXED)) {
+        (void)thread_rng_reseed(rng);
+    }
+
+    while (len) {
+        size_t n;
+        if (rng->avail == 0) {
+            thread_rng_budget(rng, len >= THREAD_RNG_BUFFER ? len : THREAD_RNG_BUFFER);
+            if (len >= THREAD_RNG_BUFFER) {
+                goldilocks_spongerng_next(rng->prng, out, len);
+                break;
+            }
+            goldilocks_spongerng_next(rng->prng, rng->buffer, THREAD_RNG_BUFFER);
+            rng->avail = THREAD_RNG_BUFFER;
+        }
+
+        /* Erase each byte as it is handed out */
+        n = (len < rng->avail) ? len : rng->avail;
+        memcpy(out, &rng->buffer[THREAD_RNG_BUFFER - rng->avail], n);
+        goldilocks_bzero(&rng->buffer[THREAD_RNG_BUFFER - rng->avail], n);
+        rng->avail -= n;
+        out += n;
+        len -= n;
+    }
+    return GOLDILOCKS_SUCCESS;
+}
+
+void goldilocks_thread_rng_set_reseed (
+    uint64_t bytes,
+    unsigned int seconds
+) {
+    __atomic_store_n(&reseed_bytes, bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&reseed_seconds, seconds, __ATOMIC_RELAXED);
+}
+
+static void *harvest (void *arg) {
+    uint8_t seed[sizeof(harvest_seed)];
+    struct timespec until;
+    (void)arg;
+
+    pthread_mutex_lock(&harvest_lock);
+    while (harvest_running) {
+        goldilocks_error_t ret;
+        pthread_mutex_unlock(&harvest_lock);
+        ret = get_os_entropy(seed, sizeof(seed));
+        pthread_mutex_lock(&harvest_lock);
+
+        if (ret == GOLDILOCKS_SUCCESS) {
+            memcpy(harvest_seed, seed, sizeof(seed));
+            __atomic_add_fetch(&harvest_epoch, 1, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&harvest_ok, ret == GOLDILOCKS_SUCCESS, __ATOMIC_RELAXED);
+
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_sec += harvest_seconds;
+        while (harvest_running
+            && pthread_cond_timedwait(&harvest_cond, &harvest_lock, &until) != ETIMEDOUT);
+    }
+    pthread_mutex_unlock(&harvest_lock);
+    goldilocks_bzero(seed, sizeof(seed));
+    return NULL;
+}
+
+goldilocks_error_t goldilocks_thread_rng_background_reseed (
+    unsigned int seconds
+) {
+    goldilocks_error_t ret = GOLDILOCKS_SUCCESS;
+    int was_running, err;
+
+    pthread_once(&thread_rng_once, thread_rng_init);
+    if (!thread_rng_key_ok) return GOLDILOCKS_FAILURE;
+
+    /* Stop the old thread, if any */
+    pthread_mutex_lock(&harvest_control);
+    pthread_mutex_lock(&harvest_lock);
+    was_running = harvest_running;
+    __atomic_store_n(&harvest_running, 0, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&harvest_cond);
+    pthread_mutex_unlock(&harvest_lock);
+    if (was_running) pthread_join(harvest_thread, NULL);
+    __atomic_store_n(&harvest_ok, 0, __ATOMIC_RELAXED);
+
+    if (seconds) {
+        pthread_mutex_lock(&harvest_lock);
+        harvest_seconds = seconds;
+        __atomic_store_n(&harvest_running, 1, __ATOMIC_RELAXED);
+        err = pthread_create(&harvest_thread, NULL, harvest, NULL);
+        if (err) {
+            errno = err;
+            __atomic_store_n(&harvest_running, 0, __ATOMIC_RELAXED);
+            ret = GOLDILOCKS_FAILURE;
+        }
+        pthread_mutex_unlock(&harvest_lock);
+    }
+    pthread_mutex_unlock(&harvest_control);
+    return ret;
 }
@@ -13,6 +13,7 @@
 #include <goldilocks/shake.hxx>
 #include <goldilocks/spongerng.hxx>
 #include <goldilocks/eddsa.hxx>
+#include <goldilocks/batch_verifier.hxx>
 #include <stdio.h>
 #include <sys/time.h>
 #include <assert.h>
@@ -157,6 +158,44 @@ static void cfrg() {
     FixedArrayBuffer<Group::DhLadder::PRIVATE_BYTES> s1(rng);
     for (Benchmark b("RFC 7748 keygen"); b.iter(); ) { Group::DhLadder::derive_public_key(s1); }
     for (Benchmark b("RFC 7748 shared secret"); b.iter(); ) { Group::DhLadder::shared_secret(base,s1); }
+    {
+        FixedArrayBuffer<Group::DhLadder::PRIVATE_BYTES> s2(rng);
+        SecureBuffer peer_pub = Group::DhLadder::derive_public_key(s2);
+        for (Benchmark b("RFC 7748 prepare peer"); b.iter(); ) {
+            typename Group::DhLadder::PreparedPeer peer(peer_pub);
+        }
+        typename Group::DhLadder::PreparedPeer peer(peer_pub);
+        for (Benchmark b("RFC 7748 prepared shared secret"); b.iter(); ) { peer.shared_secret(s1); }
+    }
+    {
+        const int nbatch = 64;
+        const size_t PB = Group::DhLadder::PUBLIC_BYTES, SB = Group::DhLadder::PRIVATE_BYTES;
+        SecureBuffer bases(nbatch*PB), scalars(nbatch*SB), outs(nbatch*PB);
+        rng.read(bases);
+        rng.read(scalars);
+        for (Benchmark b("RFC 7748 shared secret x64", 0.1); b.iter(); ) {
+            for (int i=0; i<nbatch; i++) ignore_result(goldilocks_x448(&outs[i*PB], &bases[i*PB], &scalars[i*SB]));
+        }
+        for (Benchmark b("RFC 7748 shared secret batch x64", 0.1); b.iter(); ) {
+            ignore_result(goldilocks_x448_batch(outs.data(), NULL, bases.data(), scalars.data(), nbatch));
+        }
+        for (Benchmark b("RFC 7748 keygen x64", 0.1); b.iter(); ) {
+            for (int i=0; i<nbatch; i++) goldilocks_x448_derive_public_key(&outs[i*PB], &scalars[i*SB]);
+        }
+        for (Benchmark b("RFC 7748 keygen batch x64", 0.1); b.iter(); ) {
+            goldilocks_x448_derive_public_key_batch(outs.data(), scalars.data(), nbatch);
+        }
+
+        const size_t EB = GOLDILOCKS_EDDSA_448_PRIVATE_BYTES;
+        SecureBuffer privs(nbatch*EB), pubs(nbatch*EB);
+        rng.read(privs);
+        for (Benchmark b("EdDSA keygen x64", 0.1); b.iter(); ) {
+            for (int i=0; i<nbatch; i++) goldilocks_ed448_derive_public_key(&pubs[i*EB], &privs[i*EB]);
+        }
+        for (Benchmark b("EdDSA keygen batch x64", 0.1); b.iter(); ) {
+            goldilocks_ed448_derive_public_key_batch(pubs.data(), privs.data(), nbatch);
+        }
+    }
 
     FixedArrayBuffer<EdDSA<Group>::PrivateKey::SER_BYTES> e1(rng);
     typename EdDSA<Group>::PublicKey pub((NOINIT()));
@@ -165,7 +204,55 @@ static void cfrg() {
     for (Benchmark b("EdDSA keygen"); b.iter(); ) { priv = e1; }
     for (Benchmark b("EdDSA sign"); b.iter(); ) { sig = priv.sign(Block(NULL,0)); }
     pub = priv;
+    {
+        SecureBuffer sk = priv.serialize(), pk = pub.serialize();
+        for (Benchmark b("EdDSA sign, unexpanded"); b.iter(); ) {
+            goldilocks_ed448_sign(sig.data(),sk.data(),pk.data(),NULL,0,0,NULL,0);
+        }
+    }
     for (Benchmark b("EdDSA verify"); b.iter(); ) { pub.verify(sig,Block(NULL,0)); }
+    for (Benchmark b("EdDSA verify strict"); b.iter(); ) { pub.verify_strict(sig,Block(NULL,0)); }
+    {
+        typename EdDSA<Group>::PreparedPublicKey prepared(pub);
+        for (Benchmark b("EdDSA prepare"); b.iter(); ) {
+            typename EdDSA<Group>::PreparedPublicKey prepared2(pub);
+        }
+        for (Benchmark b("EdDSA verify prepared"); b.iter(); ) { prepared.verify(sig,Block(NULL,0)); }
+    }
+
+    const int nbatch = 64;
+    std::vector<typename EdDSA<Group>::PublicKey> pubs;
+    std::vector<SecureBuffer> sigs;
+    typename EdDSA<Group>::SignatureBatch batch;
+    for (int i=0; i<nbatch; i++) {
+        typename EdDSA<Group>::PrivateKey priv2(rng);
+        pubs.push_back(typename EdDSA<Group>::PublicKey(priv2));
+        sigs.push_back(priv2.sign(Block(NULL,0)));
+    }
+    for (int i=0; i<nbatch; i++) batch.add(pubs[i],sigs[i],Block(NULL,0));
+    for (Benchmark b("EdDSA verify x64"); b.iter(); ) {
+        for (int i=0; i<nbatch; i++) pubs[i].verify(sigs[i],Block(NULL,0));
+    }
+    for (Benchmark b("EdDSA batch verify x64"); b.iter(); ) { batch.verify(); }
+    {
+        typename EdDSA<Group>::SignatureBatch batch4;
+        for (int i=0; i<4; i++) batch4.add(pubs[i],sigs[i],Block(NULL,0));
+        for (Benchmark b("EdDSA verify x4"); b.iter(); ) {
+            for (int i=0; i<4; i++) pubs[i].verify(sigs[i],Block(NULL,0));
+        }
+        for (Benchmark b("EdDSA batch verify x4"); b.iter(); ) { batch4.verify(); }
+    }
+    {
+        BatchVerifier verifier;
+        BatchVerifier::Callback ignore = [](goldilocks_error_t) {};
+        printf("Batch verifier with %d threads:\n", (int)verifier.threads());
+        for (Benchmark b("EdDSA batch verifier x1024", 0.1); b.iter(); ) {
+            for (int i=0; i<1024; i++) {
+                verifier.submit(pubs[i%nbatch],sigs[i%nbatch],Block(NULL,0),ignore);
+            }
+            verifier.wait();
+        }
+    }
 }
 
 static void macro() {
@@ -185,6 +272,16 @@ static void micro() {
     for (Benchmark b("Scalar add", 1000); b.iter(); ) { s+=t; }
     for (Benchmark b("Scalar times", 100); b.iter(); ) { s*=t; }
     for (Benchmark b("Scalar inv", 1); b.iter(); ) { s.inverse(); }
+    {
+        std::vector<Scalar> in, out;
+        for (int i=0; i<64; i++) in.push_back(Scalar(rng));
+        for (Benchmark b("Scalar inv x64", 0.1); b.iter(); ) {
+            for (int i=0; i<64; i++) in[i].inverse();
+        }
+        for (Benchmark b("Scalar batch inv x64", 0.1); b.iter(); ) {
+            ignore_result(Scalar::batch_inverse_noexcept(out,in));
+        }
+    }
     for (Benchmark b("Point add", 100); b.iter(); ) { p += q; }
     for (Benchmark b("Point double", 100); b.iter(); ) { p.double_in_place(); }
     for (Benchmark b("Point scalarmul"); b.iter(); ) { p * s; }
@@ -199,11 +296,93 @@ static void micro() {
     for (Benchmark b("Point double scalarmul"); b.iter(); ) { Point::double_scalarmul(p,s,q,t); }
     for (Benchmark b("Point dual scalarmul"); b.iter(); ) { p.dual_scalarmul(p,q,s,t); }
     for (Benchmark b("Point precmp scalarmul"); b.iter(); ) { pBase * s; }
+
+    /* Comb geometries n,t,s: the configure --with-comb-table profiles, then some others */
+    const unsigned int combs[][3] = {{2,4,56}, {5,5,18}, {10,5,9}, {2,5,45}, {4,6,19}, {8,6,10}};
+    for (unsigned int i=0; i<sizeof(combs)/sizeof(combs[0]); i++) {
+        size_t size = goldilocks_448_sizeof_precomputed_comb(combs[i][0],combs[i][1],combs[i][2]);
+        void *table;
+        if (posix_memalign(&table, goldilocks_448_alignof_precomputed_s, size)) throw std::bad_alloc();
+        if (goldilocks_448_precompute_comb((goldilocks_448_precomputed_comb_s *)table,
+            goldilocks_448_point_base, combs[i][0], combs[i][1], combs[i][2]) != GOLDILOCKS_SUCCESS
+        ) {
+            free(table);
+            continue;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "Comb %u,%u,%u scalarmul (%zukiB)",
+            combs[i][0], combs[i][1], combs[i][2], (size+512)/1024);
+        for (Benchmark b(name); b.iter(); ) {
+            goldilocks_448_precomputed_comb_scalarmul(p.p,(const goldilocks_448_precomputed_comb_s *)table,s.s);
+        }
+        goldilocks_448_precomputed_comb_destroy((goldilocks_448_precomputed_comb_s *)table);
+        free(table);
+    }
+
+    {
+        const int nbatch = 64;
+        void *pts_mem;
+        if (posix_memalign(&pts_mem, sizeof(goldilocks_448_point_p), nbatch*sizeof(goldilocks_448_point_p))) {
+            throw std::bad_alloc();
+        }
+        goldilocks_448_point_p *pts = (goldilocks_448_point_p *)pts_mem;
+        SecureBuffer sers(nbatch*Point::SER_BYTES), encs(nbatch*GOLDILOCKS_EDDSA_448_PUBLIC_BYTES);
+        for (int i=0; i<nbatch; i++) goldilocks_448_point_copy(pts[i], Point(rng).p);
+
+        for (Benchmark b("Point encode x64", 0.1); b.iter(); ) {
+            for (int i=0; i<nbatch; i++) goldilocks_448_point_encode(&sers[i*Point::SER_BYTES], pts[i]);
+        }
+        for (Benchmark b("Point encode batch x64", 0.1); b.iter(); ) {
+            goldilocks_448_point_encode_batch(sers.data(), pts, nbatch);
+        }
+        for (Benchmark b("Point decode x64", 0.1); b.iter(); ) {
+            for (int i=0; i<nbatch; i++) {
+                ignore_result(goldilocks_448_point_decode(pts[i], &sers[i*Point::SER_BYTES], GOLDILOCKS_FALSE));
+            }
+        }
+        for (Benchmark b("Point decode batch x64", 0.1); b.iter(); ) {
+            ignore_result(goldilocks_448_point_decode_batch(pts, NULL, sers.data(), nbatch, GOLDILOCKS_FALSE));
+        }
+        for (Benchmark b("Point encode like EdDSA x64", 0.1); b.iter(); ) {
+            for (int i=0; i<nbatch; i++) {
+                goldilocks_448_point_mul_by_ratio_and_encode_like_eddsa(&encs[i*GOLDILOCKS_EDDSA_448_PUBLIC_BYTES], pts[i]);
+            }
+        }
+        for (Benchmark b("Point encode like EdDSA batch x64", 0.1); b.iter(); ) {
+            goldilocks_448_point_mul_by_ratio_and_encode_like_eddsa_batch(encs.data(), pts, nbatch);
+        }
+        for (Benchmark b("Point encode like X448 x64", 0.1); b.iter(); ) {
+            for (int i=0; i<nbatch; i++) {
+                goldilocks_448_point_mul_by_ratio_and_encode_like_x448(&encs[i*GOLDILOCKS_X448_PUBLIC_BYTES], pts[i]);
+            }
+        }
+        for (Benchmark b("Point encode like X448 batch x64", 0.1); b.iter(); ) {
+            goldilocks_448_point_mul_by_ratio_and_encode_like_x448_batch(encs.data(), pts, nbatch);
+        }
+        for (int i=0; i<nbatch; i++) goldilocks_448_point_destroy(pts[i]);
+        free(pts_mem);
+    }
+
     for (Benchmark b("Point double scalarmul_v"); b.iter(); ) {
         s = Scalar(rng);
         t = Scalar(rng);
         p.non_secret_combo_with_base(s,t);
     }
+
+    const int msm_sizes[] = {16, 64, 256, 1024};
+    for (unsigned int i=0; i<sizeof(msm_sizes)/sizeof(msm_sizes[0]); i++) {
+        std::vector<Point> points;
+        std::vector<Scalar> scalars;
+        for (int j=0; j<msm_sizes[i]; j++) {
+            points.push_back(Point(rng));
+            scalars.push_back(Scalar(rng));
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "Point multiscalarmul/%d", msm_sizes[i]);
+        for (Benchmark b(name, 0.05); b.iter(); ) {
+            Point::multiscalarmul_non_secret(points,scalars);
+        }
+    }
 }
 
 }; /* template <typename group> struct Benches */
@@ -228,6 +407,39 @@ int main(int argc, char **argv) {
         for (Benchmark b("SHAKE256 1kiB", 30); b.iter(); ) { shake2 += Buffer(b1024,1024); }
         for (Benchmark b("SHA3-512 1kiB", 30); b.iter(); ) { sha5 += Buffer(b1024,1024); }
 
+        unsigned char b64x8[8][64] = {{1}};
+        const uint8_t *ins[8];
+        uint8_t *outs[8];
+        for (int j=0; j<8; j++) { ins[j] = outs[j] = b64x8[j]; }
+        for (Benchmark b("SHAKE256 8x64B", 30); b.iter(); ) {
+            for (int j=0; j<8; j++) goldilocks_shake256_hash(outs[j], 64, ins[j], 64);
+        }
+        for (Benchmark b("SHAKE256 8x64B, x4", 30); b.iter(); ) {
+            goldilocks_shake256_x4_hash(outs, 64, ins, 64);
+            goldilocks_shake256_x4_hash(outs+4, 64, ins+4, 64);
+        }
+        for (Benchmark b("SHAKE256 8x64B, x8", 30); b.iter(); ) {
+            goldilocks_shake256_x8_hash(outs, 64, ins, 64);
+        }
+
+        SecureBuffer b64k(65536);
+        for (Benchmark b("SHAKE128 64kiB"); b.iter(); ) { SHAKE<128>::hash(b64k, 32); }
+        for (Benchmark b("KangarooTwelve 64kiB"); b.iter(); ) { KangarooTwelve::hash(b64k, 32); }
+        for (Benchmark b("ParallelHash128 64kiB"); b.iter(); ) { ParallelHash<128>::hash(b64k, 8192, 32); }
+
+        {
+            SpongeRng srng;
+            ThreadRng trng;
+            uint8_t x[57];
+            for (Benchmark b("SpongeRng 57B", 1000); b.iter(); ) { srng.read(Buffer(x,sizeof(x))); }
+            for (Benchmark b("ThreadRng 57B", 1000); b.iter(); ) { trng.read(Buffer(x,sizeof(x))); }
+        }
+
+        for (Benchmark b("SecureBuffer 57B", 1000); b.iter(); ) { SecureBuffer x(57); }
+        if (goldilocks_secure_pool_enable(1<<20) == GOLDILOCKS_SUCCESS) {
+            for (Benchmark b("SecureBuffer 57B, pooled", 1000); b.iter(); ) { SecureBuffer x(57); }
+        }
+
         run_for_all_curves<Micro>();
     }
 
@@ -13,7 +13,12 @@
 #include <goldilocks/spongerng.hxx>
 #include <goldilocks/eddsa.hxx>
 #include <goldilocks/shake.hxx>
+#include <goldilocks/batch_verifier.hxx>
 #include <stdio.h>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace goldilocks;
 
@@ -204,6 +209,88 @@ static void test_arithmetic() {
     }
 }
 
+static void test_batch_invert() {
+    SpongeRng rng(Block("test_batch_invert"),SpongeRng::DETERMINISTIC);
+    Test test("Batch inversion");
+    const int sizes[] = {0,1,2,3,17,100};
+
+    for (unsigned int i=0; i<sizeof(sizes)/sizeof(sizes[0]) && test.passing_now; i++) {
+        for (int zeros=0; zeros<2; zeros++) {
+            std::vector<Scalar> in, out;
+            goldilocks_error_t expected = GOLDILOCKS_SUCCESS;
+            for (int j=0; j<sizes[i]; j++) {
+                in.push_back((zeros && j%9 == 4) ? Scalar(0) : Scalar(rng));
+            }
+
+            goldilocks_error_t ret = Scalar::batch_inverse_noexcept(out,in);
+            for (int j=0; j<sizes[i]; j++) {
+                Scalar r;
+                if (in[j].inverse_noexcept(r) != GOLDILOCKS_SUCCESS) expected = GOLDILOCKS_FAILURE;
+                if (r != out[j]) {
+                    test.fail();
+                    printf("    Batch inversion of element %d of %d differs\n", j, sizes[i]);
+                }
+            }
+            if (ret != expected) {
+                test.fail();
+                printf("    Batch inversion of %d elements returned the wrong result\n", sizes[i]);
+            }
+
+            try {
+                out = Scalar::batch_inverse(in);
+                if (expected != GOLDILOCKS_SUCCESS) {
+                    test.fail();
+                    printf("    Batch inverted zero!\n");
+                }
+            } catch(CryptoException&) {
+                if (expected == GOLDILOCKS_SUCCESS) {
+                    test.fail();
+                    printf("    Batch inversion of nonzero elements threw\n");
+                }
+            }
+        }
+    }
+}
+
+static void test_inversion() {
+    SpongeRng rng(Block("test_inversion"),SpongeRng::DETERMINISTIC);
+    Test test("Inversion");
+    Scalar y(0), z(0);
+
+    /* Exercises whichever field and scalar inversion the library was built with */
+    arith_check(test,1,y,z,Scalar(1).inverse(),1,"invert 1");
+    arith_check(test,-1,y,z,Scalar(-1).inverse(),-1,"invert -1");
+    try {
+        y = Scalar(0).inverse();
+        test.fail();
+        printf("  Inverted zero!");
+    } catch(CryptoException&) {}
+
+    for (int i=0; i<NTESTS && test.passing_now; i++) {
+        Scalar x(rng);
+        if (x == 0) continue;
+        arith_check(test,x,y,z,x*x.inverse(),1,"x * 1/x");
+        arith_check(test,x,y,z,x.inverse().inverse(),x,"double inverse");
+
+        Point p(rng), q(p), r(p);
+        try {
+            point_check(test,p,q,r,x,0,Point(p.serialize()),p,"Encode round-trip");
+        } catch (CryptoException&) {
+            test.fail();
+            printf("    Decode of an encoded point failed.\n");
+        }
+
+        for (int j=1; j<Group::REMOVED_COFACTOR; j<<=1) q = q.times_two();
+        if (r.decode_like_eddsa_and_mul_by_ratio_noexcept(
+            p.mul_by_ratio_and_encode_like_eddsa()
+        ) != GOLDILOCKS_SUCCESS) {
+            test.fail();
+            printf("    Decode like EdDSA failed.\n");
+        }
+        point_check(test,p,q,r,x,0,q,r,"Encode like EdDSA round-trip");
+    }
+}
+
 static const Block sqrt_minus_one;
 static const Block minus_sqrt_minus_one;
 static const Block elli_patho; /* sqrt(1/(u(1-d))) */
@@ -408,7 +495,46 @@ static void test_ec() {
         point_check(test,p,q,r,x,y,y*p,d2,"dual mul 2");
 
         point_check(test,base,q,r,x,y,x*base+y*q,q.non_secret_combo_with_base(y,x),"ds vt mul");
+        {
+            goldilocks_448_precomputed_wnaf_p table;
+            Point combo((NOINIT()));
+            goldilocks_448_precompute_wnaf(table,q.p);
+            goldilocks_448_base_double_scalarmul_precomputed_non_secret(combo.p,x.s,table,y.s);
+            point_check(test,base,q,r,x,y,x*base+y*q,combo,"ds vt mul precomputed");
+            goldilocks_448_base_double_scalarmul_precomputed_non_secret(combo.p,x.s,table,Scalar(0).s);
+            point_check(test,base,q,r,x,0,x*base,combo,"ds vt mul precomputed, zero");
+        }
         point_check(test,p,q,r,x,0,Precomputed(p)*x,p*x,"precomp mul");
+        {
+            /* Comb tables of a few geometries, including one that overshoots the scalar */
+            const unsigned int combs[][3] = {{2,4,56}, {10,5,9}, {3,6,25}};
+            for (unsigned int j=0; j<sizeof(combs)/sizeof(combs[0]); j++) {
+                size_t size = goldilocks_448_sizeof_precomputed_comb(combs[j][0],combs[j][1],combs[j][2]);
+                void *table;
+                if (!size || posix_memalign(&table, goldilocks_448_alignof_precomputed_s, size)) {
+                    test.fail();
+                    printf("    Can't allocate comb table %u,%u,%u\n", combs[j][0],combs[j][1],combs[j][2]);
+                    continue;
+                }
+                goldilocks_448_precomputed_comb_s *comb = (goldilocks_448_precomputed_comb_s *)table;
+                Point pc((NOINIT()));
+                if (GOLDILOCKS_SUCCESS != goldilocks_448_precompute_comb(comb,p.p,combs[j][0],combs[j][1],combs[j][2])) {
+                    test.fail();
+                    printf("    Comb table %u,%u,%u rejected\n", combs[j][0],combs[j][1],combs[j][2]);
+                } else {
+                    goldilocks_448_precomputed_comb_scalarmul(pc.p,comb,x.s);
+                    point_check(test,p,q,r,x,0,pc,p*x,"comb mul");
+                    goldilocks_448_precomputed_comb_destroy(comb);
+                }
+                free(table);
+            }
+            if (goldilocks_448_sizeof_precomputed_comb(4,4,20) || goldilocks_448_sizeof_precomputed_comb(2,11,30)
+                || goldilocks_448_sizeof_precomputed_comb(1,2,0x80000100u)
+                || goldilocks_448_sizeof_precomputed_comb(0x800001u,10,45)) {
+                test.fail();
+                printf("    Bad comb geometry accepted\n");
+            }
+        }
         point_check(test,p,q,r,0,0,r,
             Point::from_hash(Buffer(buffer).slice(0,Point::HASH_BYTES))
             + Point::from_hash(Buffer(buffer).slice(Point::HASH_BYTES,Point::HASH_BYTES)),
@@ -475,6 +601,13 @@ static void test_cfrg_crypto() {
             printf("    Shared secrets disagree on iteration %d.\n",i);
         }
 
+        FixedArrayBuffer<DhLadder::PUBLIC_BYTES> ss3;
+        DhLadder::shared_secret(ss3,p2,s1);
+        if (!ss3.contents_equal(ss1)) {
+            test.fail();
+            printf("    Shared secret into a buffer disagrees on iteration %d.\n",i);
+        }
+
         p1 = DhLadder::shared_secret(DhLadder::base_point(),s1);
         p2 = DhLadder::derive_public_key(s1);
         if (!memeq(p1,p2)) {
@@ -488,6 +621,107 @@ static void test_cfrg_crypto() {
     }
 }
 
+static void test_x448_prepared() {
+    Test test("X448 prepared peers");
+    SpongeRng rng(Block("test_x448_prepared"),SpongeRng::DETERMINISTIC);
+
+    for (int i=0; i<NTESTS/10 && test.passing_now; i++) {
+        FixedArrayBuffer<DhLadder::PRIVATE_BYTES> s1(rng), s2(rng);
+        FixedArrayBuffer<DhLadder::PUBLIC_BYTES> pk(rng), out1, out2;
+
+        /* Honest keys, and random ones on the curve or its twist */
+        if (i%3 == 0) DhLadder::derive_public_key_noexcept(pk,s2);
+
+        /* Small order: 0, 1 and -1 */
+        if (i == 1 || i == 2) {
+            for (unsigned j=0; j<pk.size(); j++) pk[j] = 0;
+            pk[0] = i-1;
+        } else if (i == 4) {
+            for (unsigned j=0; j<pk.size(); j++) pk[j] = 0xff;
+            pk[0] = pk[28] = 0xfe;
+        }
+
+        typename DhLadder::PreparedPeer peer(pk);
+        goldilocks_error_t e1 = DhLadder::shared_secret_noexcept(out1,pk,s1);
+        goldilocks_error_t e2 = peer.shared_secret_noexcept(out2,s1);
+        if (e1 != e2 || !out1.contents_equal(out2)) {
+            test.fail();
+            printf("    Prepared shared secret disagrees with ladder on iteration %d.\n",i);
+        }
+        if (e1 == GOLDILOCKS_SUCCESS) {
+            peer.shared_secret(out2,s1);
+            if (!out1.contents_equal(out2)) {
+                test.fail();
+                printf("    Prepared shared secret into a buffer disagrees on iteration %d.\n",i);
+            }
+        }
+    }
+}
+
+static void test_x448_batch() {
+    Test test("X448 batch");
+    SpongeRng rng(Block("test_x448_batch"),SpongeRng::DETERMINISTIC);
+    const unsigned int sizes[] = {1,2,3,5,8,9,17,70};
+    const unsigned int MAXN = 70;
+    const size_t PB = DhLadder::PUBLIC_BYTES, SB = DhLadder::PRIVATE_BYTES;
+    uint8_t base[MAXN*PB], scalar[MAXN*SB], out[MAXN*PB], out1[PB];
+    goldilocks_error_t results[MAXN];
+
+    for (unsigned int i=0; i<sizeof(sizes)/sizeof(sizes[0]) && test.passing_now; i++) {
+        const unsigned int n = sizes[i];
+        rng.read(Buffer(base,n*PB));
+        rng.read(Buffer(scalar,n*SB));
+
+        /* Some points of small order */
+        for (unsigned int j=1; j<n; j+=4) {
+            memset(&base[j*PB],0,PB);
+            base[j*PB] = (j/4)%2;
+        }
+
+        goldilocks_error_t all = goldilocks_x448_batch(out, results, base, scalar, n);
+        goldilocks_error_t expect_all = GOLDILOCKS_SUCCESS;
+        for (unsigned int j=0; j<n && test.passing_now; j++) {
+            goldilocks_error_t r = goldilocks_x448(out1, &base[j*PB], &scalar[j*SB]);
+            if (r != GOLDILOCKS_SUCCESS) expect_all = GOLDILOCKS_FAILURE;
+            if (r != results[j] || memcmp(out1, &out[j*PB], PB)) {
+                test.fail();
+                printf("    Batch X448 %u of %u differs\n", j, n);
+            }
+        }
+        if (all != expect_all) {
+            test.fail();
+            printf("    Batch X448 of %u returned the wrong result\n", n);
+        }
+    }
+}
+
+static void test_batch_keygen() {
+    Test test("Batch keygen");
+    SpongeRng rng(Block("test_batch_keygen"),SpongeRng::DETERMINISTIC);
+    const unsigned int sizes[] = {1,3,4,5,9,64,70};
+    const unsigned int MAXN = 70;
+    const size_t EB = GOLDILOCKS_EDDSA_448_PUBLIC_BYTES, XB = DhLadder::PUBLIC_BYTES;
+    uint8_t priv[MAXN*EB], epub[MAXN*EB], epub1[EB], xpriv[MAXN*XB], xpub[MAXN*XB], xpub1[XB];
+
+    for (unsigned int i=0; i<sizeof(sizes)/sizeof(sizes[0]) && test.passing_now; i++) {
+        const unsigned int n = sizes[i];
+        rng.read(Buffer(priv,n*EB));
+        rng.read(Buffer(xpriv,n*XB));
+
+        goldilocks_ed448_derive_public_key_batch(epub, priv, n);
+        goldilocks_x448_derive_public_key_batch(xpub, xpriv, n);
+        for (unsigned int j=0; j<n; j++) {
+            goldilocks_ed448_derive_public_key(epub1, &priv[j*EB]);
+            goldilocks_x448_derive_public_key(xpub1, &xpriv[j*XB]);
+            if (memcmp(epub1, &epub[j*EB], EB) || memcmp(xpub1, &xpub[j*XB], XB)) {
+                test.fail();
+                printf("    Batch keygen of key %u of %u differs\n", j, n);
+                break;
+            }
+        }
+    }
+}
+
 static const bool eddsa_prehashed[];
 static const Block eddsa_sk[], eddsa_pk[], eddsa_message[], eddsa_context[], eddsa_sig[];
 
@@ -535,6 +769,12 @@ static void test_cfrg_vectors() {
         try {
             if (!eddsa_prehashed[t]) {
                 priv.pub().verify(eddsa_sig[t], eddsa_message[t], eddsa_context[t]);
+                priv.pub().verify_strict(eddsa_sig[t], eddsa_message[t], eddsa_context[t]);
+            } else {
+                typename EdDSA<Group>::PrivateKeyPh priv2(eddsa_sk[t]);
+                typename EdDSA<Group>::Prehash ph(eddsa_context[t]);
+                ph += eddsa_message[t];
+                priv2.pub().verify_strict_prehashed(eddsa_sig[t], ph);
             }
         } catch(CryptoException&) {
             test.fail();
@@ -565,6 +805,103 @@ static void test_cfrg_vectors() {
     }
 }
 
+static void test_multiscalarmul() {
+    Test test("Multi-scalar multiply");
+    SpongeRng rng(Block("test_multiscalarmul"),SpongeRng::DETERMINISTIC);
+    const int sizes[] = {0,1,2,3,7,33,100,300,700};
+
+    for (unsigned int i=0; i<sizeof(sizes)/sizeof(sizes[0]) && test.passing_now; i++) {
+        for (int shortness=0; shortness<2; shortness++) {
+            std::vector<Point> points;
+            std::vector<Scalar> scalars;
+            Point expected = Point::identity();
+            for (int j=0; j<sizes[i]; j++) {
+                points.push_back(Point(rng));
+                if (j%11 == 5) {
+                    scalars.push_back(Scalar(0));
+                } else if (shortness) {
+                    SecureBuffer sb(16);
+                    rng.read(sb);
+                    scalars.push_back(Scalar(sb));
+                } else {
+                    scalars.push_back(Scalar(rng));
+                }
+                expected += points[j] * scalars[j];
+            }
+
+            Point result = Point::multiscalarmul_non_secret(points,scalars);
+            if (result != expected) {
+                test.fail();
+                printf("    Multi-scalar multiply of %d points failed\n", sizes[i]);
+            }
+        }
+    }
+}
+
+static void test_batch_encode() {
+    Test test("Batch encoding");
+    SpongeRng rng(Block("test_batch_encode"),SpongeRng::DETERMINISTIC);
+    const unsigned int sizes[] = {1,2,5,9,64,70};
+    const unsigned int MAXN = 70;
+    const size_t SB = Point::SER_BYTES, EB = GOLDILOCKS_EDDSA_448_PUBLIC_BYTES, XB = GOLDILOCKS_X448_PUBLIC_BYTES;
+    goldilocks_448_point_p pts[MAXN], dec[MAXN], single;
+    goldilocks_error_t results[MAXN];
+    uint8_t ser[MAXN*SB], ser1[SB], enc[MAXN*EB], enc1[EB], xenc[MAXN*XB], xenc1[XB];
+
+    for (unsigned int i=0; i<sizeof(sizes)/sizeof(sizes[0]) && test.passing_now; i++) {
+        const unsigned int n = sizes[i];
+        for (unsigned int j=0; j<n; j++) {
+            Point p = (j%7 == 3) ? Point::identity() : Point(rng);
+            goldilocks_448_point_copy(pts[j], p.p);
+        }
+
+        goldilocks_448_point_encode_batch(ser, pts, n);
+        goldilocks_448_point_mul_by_ratio_and_encode_like_eddsa_batch(enc, pts, n);
+        goldilocks_448_point_mul_by_ratio_and_encode_like_x448_batch(xenc, pts, n);
+        for (unsigned int j=0; j<n; j++) {
+            goldilocks_448_point_encode(ser1, pts[j]);
+            goldilocks_448_point_mul_by_ratio_and_encode_like_eddsa(enc1, pts[j]);
+            goldilocks_448_point_mul_by_ratio_and_encode_like_x448(xenc1, pts[j]);
+            if (memcmp(ser1, &ser[j*SB], SB)
+                || memcmp(enc1, &enc[j*EB], EB)
+                || memcmp(xenc1, &xenc[j*XB], XB)
+            ) {
+                test.fail();
+                printf("    Batch encoding of point %u of %u differs\n", j, n);
+                break;
+            }
+        }
+
+        if (goldilocks_448_point_decode_batch(dec, results, ser, n, GOLDILOCKS_TRUE) != GOLDILOCKS_SUCCESS) {
+            test.fail();
+            printf("    Batch decoding of %u points failed\n", n);
+        }
+        for (unsigned int j=0; j<n && test.passing_now; j++) {
+            if (!goldilocks_448_point_eq(dec[j], pts[j])) {
+                test.fail();
+                printf("    Batch decoding of point %u of %u differs\n", j, n);
+            }
+        }
+
+        /* Corrupt some encodings and compare each result with a single decode */
+        for (unsigned int j=0; j<n; j+=3) ser[j*SB + j%SB] ^= 1+j;
+        goldilocks_error_t all = goldilocks_448_point_decode_batch(dec, results, ser, n, GOLDILOCKS_FALSE);
+        goldilocks_error_t expect_all = GOLDILOCKS_SUCCESS;
+        for (unsigned int j=0; j<n && test.passing_now; j++) {
+            goldilocks_error_t r = goldilocks_448_point_decode(single, &ser[j*SB], GOLDILOCKS_FALSE);
+            if (r != GOLDILOCKS_SUCCESS) expect_all = GOLDILOCKS_FAILURE;
+            if (r != results[j] || (r == GOLDILOCKS_SUCCESS && !goldilocks_448_point_eq(dec[j], single))) {
+                test.fail();
+                printf("    Batch decoding of bad point %u of %u differs\n", j, n);
+            }
+        }
+        if (all != expect_all) {
+            test.fail();
+            printf("    Batch decoding of %u bad points returned the wrong result\n", n);
+        }
+    }
+}
+
 static void test_eddsa() {
     Test test("EdDSA");
     SpongeRng rng(Block("test_eddsa"),SpongeRng::DETERMINISTIC);
@@ -581,6 +918,40 @@ static void test_eddsa() {
 
         SecureBuffer sig = priv.sign(message,context);
 
+        /* The wrapper signs with the expanded key; it must agree with the one-shot call */
+        SecureBuffer sk = priv.serialize(), pk = pub.serialize();
+        FixedArrayBuffer<EdDSA<Group>::PrivateKey::SIG_BYTES> sig2;
+        goldilocks_ed448_sign(sig2.data(),sk.data(),pk.data(),message.data(),message.size(),
+            0,context.data(),context.size());
+        if (!Block(sig).contents_equal(sig2)) {
+            test.fail();
+            printf("    Expanded and one-shot signatures differ on sig %d\n", i);
+        }
+
+        /* The allocation-free versions must agree too, including from a copied prehash */
+        FixedArrayBuffer<EdDSA<Group>::PrivateKey::SIG_BYTES> sig3, sig4;
+        if (priv.sign_noexcept(sig3,message,context) != GOLDILOCKS_SUCCESS
+            || !Block(sig).contents_equal(sig3)) {
+            test.fail();
+            printf("    Signing into a buffer differs on sig %d\n", i);
+        }
+        if (i%16 == 0) {
+            typename EdDSA<Group>::Prehash ph(context);
+            ph += message;
+            typename EdDSA<Group>::Prehash ph2(ph);
+            if (priv.sign_prehashed_noexcept(sig4,ph2) != GOLDILOCKS_SUCCESS
+                || priv.sign_with_prehash_noexcept(sig3,message,context) != GOLDILOCKS_SUCCESS
+                || !sig3.contents_equal(sig4)
+                || !Block(priv.sign_prehashed(ph)).contents_equal(sig4)) {
+                test.fail();
+                printf("    Prehashed signing into a buffer differs on sig %d\n", i);
+            }
+        }
+        if (priv.sign_noexcept(sig3,message,SecureBuffer(256)) != GOLDILOCKS_FAILURE) {
+            test.fail();
+            printf("    Signing with a long context didn't fail on sig %d\n", i);
+        }
+
         try {
             pub.verify(sig,message,context);
         } catch(CryptoException&) {
@@ -588,6 +959,30 @@ static void test_eddsa() {
             printf("    Signature validation failed on sig %d\n", i);
         }
 
+        try {
+            pub.verify_strict(sig,message,context);
+        } catch(CryptoException&) {
+            test.fail();
+            printf("    Strict signature validation failed on sig %d\n", i);
+        }
+
+        typename EdDSA<Group>::PreparedPublicKey prepared(pub);
+        try {
+            prepared.verify(sig,message,context);
+        } catch(CryptoException&) {
+            test.fail();
+            printf("    Prepared signature validation failed on sig %d\n", i);
+        }
+        sig[i % sig.size()] ^= 1;
+        if (prepared.verify_noexcept(sig,message,context) != pub.verify_noexcept(sig,message,context)) {
+            test.fail();
+            printf("    Prepared and unprepared verification disagree on bad sig %d\n", i);
+        }
+        if (pub.verify_strict_noexcept(sig,message,context) == GOLDILOCKS_SUCCESS) {
+            test.fail();
+            printf("    Strict verification accepted bad sig %d\n", i);
+        }
+
         /* Test encode_like and torque */
         Point p(rng);
         SecureBuffer p1 = p.mul_by_ratio_and_encode_like_eddsa();
@@ -605,6 +1000,119 @@ static void test_eddsa() {
     }
 }
 
+static void test_eddsa_batch() {
+    Test test("EdDSA batch verify");
+    SpongeRng rng(Block("test_eddsa_batch"),SpongeRng::DETERMINISTIC);
+
+    for (int i=0; i<NTESTS/1000 && test.passing_now; i++) {
+        const int n = 1 + i*13;
+        std::vector<typename EdDSA<Group>::PublicKey> pubs;
+        std::vector<SecureBuffer> sigs, messages, contexts;
+
+        for (int j=0; j<n; j++) {
+            typename EdDSA<Group>::PrivateKey priv(rng);
+            pubs.push_back(typename EdDSA<Group>::PublicKey(priv));
+            messages.push_back(SecureBuffer(j));
+            rng.read(messages[j]);
+            contexts.push_back(SecureBuffer(j%7));
+            rng.read(contexts[j]);
+            sigs.push_back(priv.sign(messages[j],contexts[j]));
+        }
+
+        typename EdDSA<Group>::SignatureBatch batch;
+        for (int j=0; j<n; j++) batch.add(pubs[j],sigs[j],messages[j],contexts[j]);
+
+        std::vector<goldilocks_error_t> results;
+        if (GOLDILOCKS_SUCCESS != batch.verify_noexcept(results)) {
+            test.fail();
+            printf("    Batch of %d valid signatures failed\n", n);
+        }
+
+        /* Break a few of them, in the response, the nonce and the message */
+        for (int j=i%3; j<n; j+=5) {
+            if (j%3 == 0) sigs[j][sigs[j].size()-2] ^= 1;
+            else if (j%3 == 1) sigs[j][3] ^= 0x10;
+            else if (messages[j].size()) messages[j][0] ^= 1;
+            else contexts[j] = SecureBuffer(1);
+        }
+        batch.clear();
+        for (int j=0; j<n; j++) batch.add(pubs[j],sigs[j],messages[j],contexts[j]);
+
+        bool all_ok = true;
+        goldilocks_error_t ret = batch.verify_noexcept(results);
+        for (int j=0; j<n; j++) {
+            goldilocks_error_t single = pubs[j].verify_noexcept(sigs[j],messages[j],contexts[j]);
+            if (single != GOLDILOCKS_SUCCESS) all_ok = false;
+            if (single != results[j]) {
+                test.fail();
+                printf("    Batch result %d of %d differs from single verify\n", j, n);
+            }
+        }
+        if ((ret == GOLDILOCKS_SUCCESS) != all_ok
+            || (batch.verify_noexcept() == GOLDILOCKS_SUCCESS) != all_ok) {
+            test.fail();
+            printf("    Batch of %d gave the wrong overall result\n", n);
+        }
+    }
+}
+
+static void test_batch_verifier() {
+    Test test("Batch verifier");
+    SpongeRng rng(Block("test_batch_verifier"),SpongeRng::DETERMINISTIC);
+
+    const int n = 200;
+    std::vector<typename EdDSA<Group>::PublicKey> pubs;
+    std::vector<SecureBuffer> sigs, messages;
+    for (int j=0; j<n; j++) {
+        typename EdDSA<Group>::PrivateKey priv(rng);
+        pubs.push_back(typename EdDSA<Group>::PublicKey(priv));
+        messages.push_back(SecureBuffer(j%50));
+        rng.read(messages[j]);
+        sigs.push_back(priv.sign(messages[j],Block("ctx")));
+        if (j%7 == 3) sigs[j][j%sigs[j].size()] ^= 1;
+    }
+
+    std::vector<goldilocks_error_t> results(n, GOLDILOCKS_SUCCESS);
+    {
+        BatchVerifier verifier(4, 8);
+        std::vector<std::future<goldilocks_error_t> > futures;
+        for (int j=0; j<n; j++) {
+            if (j%2) {
+                goldilocks_error_t *r = &results[j];
+                verifier.submit(pubs[j],sigs[j],messages[j],
+                    [r](goldilocks_error_t e) { *r = e; }, Block("ctx"));
+            } else {
+                futures.push_back(verifier.submit(pubs[j],sigs[j],messages[j],Block("ctx")));
+            }
+        }
+        verifier.wait();
+        for (int j=0; j<n; j+=2) results[j] = futures[j/2].get();
+    }
+
+    {
+        /* A throwing callback must not wedge the verifier */
+        BatchVerifier verifier(1, 8);
+        for (int j=0; j<16; j++) {
+            verifier.submit(pubs[j],sigs[j],messages[j],
+                [](goldilocks_error_t) { throw std::runtime_error("callback"); }, Block("ctx"));
+        }
+        verifier.wait();
+        std::future<goldilocks_error_t> f = verifier.submit(pubs[0],sigs[0],messages[0],Block("ctx"));
+        if (f.get() != GOLDILOCKS_SUCCESS) {
+            test.fail();
+            printf("    Batch verifier failed after a callback threw\n");
+        }
+    }
+
+    for (int j=0; j<n; j++) {
+        goldilocks_error_t single = pubs[j].verify_noexcept(sigs[j],messages[j],Block("ctx"));
+        if (single != results[j]) {
+            test.fail();
+            printf("    Batch verifier result %d differs from single verify\n", j);
+        }
+    }
+}
+
 static void test_x448() {
     Test test("X448 Encoding/Decoding");
     SpongeRng rng(Block("test_x448"),SpongeRng::DETERMINISTIC);
@@ -682,12 +1190,21 @@ static void test_dalek_vectors() {
 static void run() {
     printf("Testing %s:\n",Group::name());
     test_arithmetic();
+    test_batch_invert();
+    test_inversion();
     test_elligator();
     test_ec();
+    test_multiscalarmul();
+    test_batch_encode();
     test_eddsa();
+    test_eddsa_batch();
+    test_batch_verifier();
     test_x448();
     test_convert_eddsa_to_x();
     test_cfrg_crypto();
+    test_x448_prepared();
+    test_x448_batch();
+    test_batch_keygen();
     test_cfrg_vectors();
     test_dalek_vectors();
     printf("\n");
@@ -718,6 +1235,172 @@ static void test_xof() {
     }
 }
 
+static void test_xof_multi(const char *name, const struct goldilocks_kparams_s *params) {
+    Test test(name);
+    SpongeRng rng(Block("test_xof_multi"),SpongeRng::DETERMINISTIC);
+    static const size_t inlens[] = {0,1,71,72,135,136,137,168,169,400};
+    static const size_t outlens[] = {0,1,32,64,136,168,400};
+
+    FixedArrayBuffer<8*400> in, out, expected;
+    rng.read(in);
+    const uint8_t *ins[8];
+    uint8_t *outs[8];
+    for (unsigned j=0; j<8; j++) {
+        ins[j] = in.data() + 400*j;
+        outs[j] = out.data() + 400*j;
+    }
+
+    for (unsigned i=0; i<sizeof(inlens)/sizeof(inlens[0]); i++) {
+        for (unsigned k=0; k<sizeof(outlens)/sizeof(outlens[0]); k++) {
+            size_t inlen = inlens[i], outlen = outlens[k];
+            for (unsigned j=0; j<8; j++) {
+                goldilocks_sha3_hash(expected.data()+400*j, outlen, ins[j], inlen, params);
+            }
+            for (unsigned n=4; n<=8; n+=4) {
+                out.zeroize();
+                if (n==4) {
+                    goldilocks_sha3_hash_x4(outs, outlen, ins, inlen, params);
+                    goldilocks_sha3_hash_x4(outs+4, outlen, ins+4, inlen, params);
+                } else {
+                    goldilocks_sha3_hash_x8(outs, outlen, ins, inlen, params);
+                }
+                for (unsigned j=0; j<8; j++) {
+                    if (memcmp(outs[j], expected.data()+400*j, outlen)) {
+                        test.fail();
+                        printf("    x%u lane %u differs, inlen=%u outlen=%u\n",
+                            n, j, (unsigned)inlen, (unsigned)outlen);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Inputs are i%251 for i = 0, 1, ... and likewise the customization strings */
+static const struct { size_t inlen, customlen, outlen; uint8_t out[64]; } k12_vectors[] = {
+    {0, 0, 32, {
+        0x1a,0xc2,0xd4,0x50,0xfc,0x3b,0x42,0x05,0xd1,0x9d,0xa7,0xbf,0xca,0x1b,0x37,0x51,
+        0x3c,0x08,0x03,0x57,0x7a,0xc7,0x16,0x7f,0x06,0xfe,0x2c,0xe1,0xf0,0xef,0x39,0xe5
+    }},
+    {17, 0, 32, {
+        0x6b,0xf7,0x5f,0xa2,0x23,0x91,0x98,0xdb,0x47,0x72,0xe3,0x64,0x78,0xf8,0xe1,0x9b,
+        0x0f,0x37,0x12,0x05,0xf6,0xa9,0xa9,0x3a,0x27,0x3f,0x51,0xdf,0x37,0x12,0x28,0x88
+    }},
+    {4913, 0, 32, {
+        0xcb,0x55,0x2e,0x2e,0xc7,0x7d,0x99,0x10,0x70,0x1d,0x57,0x8b,0x45,0x7d,0xdf,0x77,
+        0x2c,0x12,0xe3,0x22,0xe4,0xee,0x7f,0xe4,0x17,0xf9,0x2c,0x75,0x8f,0x0d,0x59,0xd0
+    }},
+    {8191, 0, 32, {
+        0x1b,0x57,0x76,0x36,0xf7,0x23,0x64,0x3e,0x99,0x0c,0xc7,0xd6,0xa6,0x59,0x83,0x74,
+        0x36,0xfd,0x6a,0x10,0x36,0x26,0x60,0x0e,0xb8,0x30,0x1c,0xd1,0xdb,0xe5,0x53,0xd6
+    }},
+    {8192, 0, 32, {
+        0x48,0xf2,0x56,0xf6,0x77,0x2f,0x9e,0xdf,0xb6,0xa8,0xb6,0x61,0xec,0x92,0xdc,0x93,
+        0xb9,0x5e,0xbd,0x05,0xa0,0x8a,0x17,0xb3,0x9a,0xe3,0x49,0x08,0x70,0xc9,0x26,0xc3
+    }},
+    {8193, 0, 32, {
+        0xbb,0x66,0xfe,0x72,0xea,0xea,0x51,0x79,0x41,0x8d,0x52,0x95,0xee,0x13,0x44,0x85,
+        0x4d,0x8a,0xd7,0xf3,0xfa,0x17,0xef,0xcb,0x46,0x7e,0xc1,0x52,0x34,0x12,0x84,0xcf
+    }},
+    {83521, 0, 32, {
+        0x87,0x01,0x04,0x5e,0x22,0x20,0x53,0x45,0xff,0x4d,0xda,0x05,0x55,0x5c,0xbb,0x5c,
+        0x3a,0xf1,0xa7,0x71,0xc2,0xb8,0x9b,0xae,0xf3,0x7d,0xb4,0x3d,0x99,0x98,0xb9,0xfe
+    }},
+    {1419857, 0, 32, {
+        0x84,0x4d,0x61,0x09,0x33,0xb1,0xb9,0x96,0x3c,0xbd,0xeb,0x5a,0xe3,0xb6,0xb0,0x5c,
+        0xc7,0xcb,0xd6,0x7c,0xee,0xdf,0x88,0x3e,0xb6,0x78,0xa0,0xa8,0xe0,0x37,0x16,0x82
+    }},
+    {8190, 3, 32, {
+        0x6c,0xa7,0xa5,0x83,0xb4,0xbe,0xaa,0x0a,0xab,0x02,0x23,0x01,0x6a,0x10,0x2b,0x21,
+        0x4f,0xe1,0xdb,0x7e,0xd3,0x25,0xb8,0xdf,0x37,0x22,0x9f,0x3e,0xee,0x55,0xda,0xa6
+    }},
+    {16384, 0, 32, {
+        0x82,0x77,0x8f,0x7f,0x72,0x34,0xc8,0x33,0x52,0xe7,0x68,0x37,0xb7,0x21,0xfb,0xdb,
+        0xb5,0x27,0x0b,0x88,0x01,0x0d,0x84,0xfa,0x5a,0xb0,0xb6,0x1e,0xc8,0xce,0x09,0x56
+    }},
+    {0, 8200, 32, {
+        0x49,0x7e,0x64,0x1c,0xca,0xbe,0x94,0xe4,0xcd,0x10,0x08,0xf6,0x1a,0xed,0x9b,0xb8,
+        0x27,0xe4,0x84,0x50,0x43,0x2b,0x10,0x61,0x9b,0x6c,0x7f,0x2e,0x52,0x13,0x67,0xde
+    }},
+    {100000, 41, 64, {
+        0x67,0x6c,0x71,0x4c,0x29,0x07,0x16,0xb7,0xe3,0xdb,0x56,0x74,0xaf,0x51,0x4a,0xe8,
+        0xc4,0x21,0xa3,0x62,0x80,0x01,0xf8,0x0f,0x97,0xc5,0x28,0xe1,0x0b,0x6f,0x8b,0x57,
+        0x28,0x0c,0x58,0x8b,0xe7,0x9b,0x38,0x65,0xb5,0x94,0x80,0xba,0xd3,0x2f,0xc2,0xd3,
+        0x3d,0x2f,0xbd,0x55,0x6c,0x0e,0x0f,0xa8,0x5a,0x13,0x7c,0x16,0x75,0x8b,0xbe,0x33
+    }},
+};
+
+static const struct { int bits; size_t inlen, blocklen, customlen, outlen; uint8_t out[64]; } parallelhash_vectors[] = {
+    {128, 24, 8, 0, 32, {
+        0xf1,0x88,0xec,0xfc,0x90,0x5f,0xe6,0xb3,0x46,0x2f,0x22,0xd9,0x4d,0x45,0x68,0xb2,
+        0xc0,0xdb,0xae,0x9c,0x3d,0xe2,0x58,0x1b,0xa3,0x9a,0xa3,0x5c,0x6f,0xbd,0x5f,0x98
+    }},
+    {128, 1000, 64, 5, 32, {
+        0x6d,0xfc,0x99,0x8e,0xbe,0x59,0x44,0x50,0xe0,0x8d,0xf3,0x3a,0x45,0x61,0x0a,0xd3,
+        0xe7,0xa8,0x95,0xae,0x7e,0x85,0x42,0xf4,0xce,0xe2,0x7f,0x41,0x4a,0xfe,0x07,0xd0
+    }},
+    {128, 100, 7, 0, 17, {
+        0x71,0x1b,0x05,0x90,0xea,0x8d,0xc8,0x43,0x06,0x70,0x3d,0x0c,0x21,0x5e,0x8b,0xff,
+        0x22
+    }},
+    {128, 0, 8, 0, 32, {
+        0x96,0x42,0x7c,0x30,0x22,0x44,0x08,0x85,0x9f,0x95,0xe8,0x9e,0x4f,0xa8,0x4e,0x1c,
+        0x7a,0x14,0x78,0xdb,0xf2,0x00,0x8a,0xc9,0x82,0xce,0x61,0xa7,0x7f,0x37,0xa2,0x72
+    }},
+    {256, 1000, 64, 5, 64, {
+        0x30,0x52,0xcb,0x7d,0xf0,0x5f,0x2e,0x89,0xf7,0x3e,0xb7,0x9b,0x05,0xfb,0xa8,0x26,
+        0xac,0x56,0x9c,0x64,0xcf,0xd7,0xf7,0x74,0x3e,0xc3,0xc8,0x3f,0xd0,0x52,0xc1,0x9d,
+        0x61,0xee,0xf2,0x9c,0xec,0x16,0xac,0xf0,0x72,0x2b,0xb4,0x6c,0x8a,0x9c,0x94,0x47,
+        0xd7,0x6a,0xd6,0x37,0xbb,0x13,0x66,0x1d,0xb0,0x90,0xb5,0x3c,0x6b,0x94,0x6b,0xff
+    }},
+    {256, 20000, 1000, 0, 64, {
+        0x15,0x11,0x5a,0x53,0xc8,0x2d,0x5e,0x03,0x27,0xa3,0x76,0x5f,0xb9,0x6e,0x5d,0xd9,
+        0xdb,0xff,0x79,0x4a,0x5f,0xa5,0x73,0x52,0xfa,0xe1,0x88,0x8b,0x9f,0x2b,0x57,0x49,
+        0xc2,0xdd,0x68,0xbb,0x0f,0x8d,0x61,0x2f,0x54,0x05,0xea,0xb9,0xd0,0x30,0x59,0x3f,
+        0x5f,0x42,0xe1,0x90,0xd8,0xea,0x43,0x18,0x29,0x0b,0xaa,0x9b,0xb0,0x27,0xcf,0x42
+    }},
+};
+
+static SecureBuffer pattern(size_t len) {
+    SecureBuffer out(len);
+    for (size_t i=0; i<len; i++) out[i] = i % 251;
+    return out;
+}
+
+static void test_kangarootwelve() {
+    Test test("KangarooTwelve");
+    for (unsigned i=0; i<sizeof(k12_vectors)/sizeof(k12_vectors[0]); i++) {
+        SecureBuffer out = KangarooTwelve::hash(
+            pattern(k12_vectors[i].inlen), k12_vectors[i].outlen, pattern(k12_vectors[i].customlen)
+        );
+        if (!Block(out).contents_equal(Block(k12_vectors[i].out, k12_vectors[i].outlen))) {
+            test.fail();
+            printf("    Mismatch with inlen=%u customlen=%u\n",
+                (unsigned)k12_vectors[i].inlen, (unsigned)k12_vectors[i].customlen);
+        }
+    }
+}
+
+static void test_parallelhash() {
+    Test test("ParallelHash");
+    for (unsigned i=0; i<sizeof(parallelhash_vectors)/sizeof(parallelhash_vectors[0]); i++) {
+        SecureBuffer in = pattern(parallelhash_vectors[i].inlen), out,
+            custom = pattern(parallelhash_vectors[i].customlen);
+        if (parallelhash_vectors[i].bits == 128) {
+            out = ParallelHash<128>::hash(in, parallelhash_vectors[i].blocklen,
+                parallelhash_vectors[i].outlen, custom);
+        } else {
+            out = ParallelHash<256>::hash(in, parallelhash_vectors[i].blocklen,
+                parallelhash_vectors[i].outlen, custom);
+        }
+        if (!Block(out).contents_equal(Block(parallelhash_vectors[i].out, parallelhash_vectors[i].outlen))) {
+            test.fail();
+            printf("    Mismatch with bits=%d inlen=%u blocklen=%u\n", parallelhash_vectors[i].bits,
+                (unsigned)parallelhash_vectors[i].inlen, (unsigned)parallelhash_vectors[i].blocklen);
+        }
+    }
+}
+
 static void test_rng() {
     Test test("RNG");
     SpongeRng rng_d1(Block("test_rng"),SpongeRng::DETERMINISTIC);
@@ -764,13 +1447,168 @@ static void test_rng() {
     }
 }
 
+static void test_thread_rng() {
+    Test test("Thread RNG");
+    ThreadRng rng;
+    SecureBuffer s1, s2, s3;
+
+    /* Short reads from the buffer, and long reads straight from the sponge */
+    for (int i=0; i<8; i++) {
+        s1 = rng.read(7<<(2*i));
+        s2 = rng.read(7<<(2*i));
+        if (s1 == s2) {
+            test.fail();
+            printf("  Thread RNG repeated itself!\n");
+        }
+    }
+
+    std::thread([&]() { s3 = ThreadRng().read(32); }).join();
+    s1 = rng.read(32);
+    if (s1 == s3) {
+        test.fail();
+        printf("  Thread RNG matched another thread!\n");
+    }
+
+    /* Reseed on every refill */
+    goldilocks_thread_rng_set_reseed(1, 0);
+    for (int i=0; i<4; i++) {
+        s1 = rng.read(5000);
+        s2 = rng.read(3);
+        if (s1 == s2 || s2 == SecureBuffer(3)) {
+            test.fail();
+            printf("  Thread RNG failed after reseeding!\n");
+        }
+    }
+    goldilocks_thread_rng_set_reseed(1<<20, 300);
+
+    /* Reseed from a background thread */
+    ThreadRng::background_reseed(1);
+    for (int i=0; i<4; i++) {
+        s1 = rng.read(5000);
+        s2 = rng.read(3);
+        if (s1 == s2 || s2 == SecureBuffer(3)) {
+            test.fail();
+            printf("  Thread RNG failed with background reseeding!\n");
+        }
+    }
+
+    /* Fork twice from the same state, with the harvest thread running in the
+     * parent.  The harvest thread doesn't survive fork(), so each child must
+     * reseed from the OS on its own: its output must match neither the
+     * parent's nor its sibling's, even after refilling its buffer.  A child
+     * also checks that it can start and stop a harvest thread of its own,
+     * which would hang trying to join the parent's if it thought that was
+     * still running.
+     */
+    int fds[2];
+    if (pipe(fds)) {
+        test.fail();
+        printf("  Couldn't make a pipe\n");
+        ThreadRng::background_reseed(0);
+        return;
+    }
+    s1 = rng.read(32);
+    SecureBuffer kids[2];
+    bool forked = true;
+    for (int k=0; k<2; k++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            s2 = rng.read(5000);
+            bool ok = goldilocks_thread_rng_background_reseed(1) == GOLDILOCKS_SUCCESS
+                && goldilocks_thread_rng_background_reseed(0) == GOLDILOCKS_SUCCESS;
+            _exit(!ok || write(fds[1], s2.data(), 32) != 32);
+        }
+        kids[k] = SecureBuffer(32);
+        int status = 0;
+        if (pid < 0 || read(fds[0], kids[k].data(), kids[k].size()) != (ssize_t)kids[k].size()
+            || waitpid(pid, &status, 0) != pid || status != 0) {
+            forked = false;
+        }
+    }
+    s1 = rng.read(32);
+    if (!forked) {
+        test.fail();
+        printf("  Couldn't read from a forked child\n");
+    } else if (s1 == kids[0] || s1 == kids[1]) {
+        test.fail();
+        printf("  Thread RNG matched after fork!\n");
+    } else if (kids[0] == kids[1]) {
+        test.fail();
+        printf("  Thread RNG matched between forked children!\n");
+    }
+    close(fds[0]);
+    close(fds[1]);
+    ThreadRng::background_reseed(0);
+}
+
 #include "vectors.inc.cxx"
 
+static void test_secure_pool() {
+    Test test("Secure pool");
+
+    if (goldilocks_secure_pool_enable(1<<20) != GOLDILOCKS_SUCCESS) {
+        test.fail();
+        printf("    Couldn't enable the pool\n");
+        return;
+    }
+
+    /* Several threads allocate and free blocks of mixed sizes, checking that
+     * nothing overlaps.  In the second round each thread frees the blocks
+     * which its neighbour allocated.
+     */
+    const int nthreads = 4, nslots = 300;
+    std::vector<uint8_t *> ptrs(nthreads*nslots, (uint8_t *)NULL);
+    std::vector<size_t> sizes(nthreads*nslots, 0);
+    std::vector<int> bad(nthreads, 0);
+    for (int round=0; round<2; round++) {
+        std::vector<std::thread> threads;
+        for (int t=0; t<nthreads; t++) {
+            threads.push_back(std::thread([&,t,round]() {
+                const int owner = (t+round) % nthreads;
+                for (int i=0; i<10000; i++) {
+                    int slot = ((i*7919) % nslots) * nthreads + owner;
+                    uint8_t *p = ptrs[slot];
+                    if (p) {
+                        for (size_t j=0; j<sizes[slot]; j++) if (p[j] != (uint8_t)slot) bad[t]++;
+                        goldilocks_secure_free(p, sizes[slot]);
+                    }
+                    sizes[slot] = 1 + (i*31 + t) % 200;
+                    p = ptrs[slot] = (uint8_t *)goldilocks_secure_malloc(sizes[slot]);
+                    if (p == NULL) { bad[t]++; continue; }
+                    memset(p, (uint8_t)slot, sizes[slot]);
+                }
+            }));
+        }
+        for (int t=0; t<nthreads; t++) threads[t].join();
+    }
+
+    /* Then free everything from here */
+    for (int slot=0; slot<nthreads*nslots; slot++) {
+        if (!ptrs[slot]) continue;
+        for (size_t j=0; j<sizes[slot]; j++) if (ptrs[slot][j] != (uint8_t)slot) bad[0]++;
+        goldilocks_secure_free(ptrs[slot], sizes[slot]);
+    }
+
+    for (int t=0; t<nthreads; t++) {
+        if (bad[t]) {
+            test.fail();
+            printf("    Thread %d saw %d corrupted bytes\n", t, bad[t]);
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     (void) argc; (void) argv;
+    test_secure_pool();
     test_rng();
+    test_thread_rng();
     test_xof<SHAKE<128> >();
     test_xof<SHAKE<256> >();
+    test_xof_multi("SHAKE128 x4/x8", &GOLDILOCKS_SHAKE128_params_s);
+    test_xof_multi("SHAKE256 x4/x8", &GOLDILOCKS_SHAKE256_params_s);
+    test_xof_multi("SHA3-512 x4/x8", &GOLDILOCKS_SHA3_512_params_s);
+    test_kangarootwelve();
+    test_parallelhash();
     printf("\n");
     run_for_all_curves<Tests>();
     if (passing) printf("Passed all tests.\n");